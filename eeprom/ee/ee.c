@@ -0,0 +1,279 @@
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include "ee.h"
+
+/**
+ * Implementation note:
+ *
+ * 	- The dirty bits are shared with the EE_RDY interrupt. The main
+ * 	  line sets them with interrupts disabled for the few cycles of the
+ * 	  read-modify-write; the interrupt clears a bit before reading the
+ * 	  byte from the cache. So a byte updated after being picked by the
+ * 	  interrupt is dirty again and is written once more.
+ *
+ * 	- A counter slot is written in the ascending order of addresses
+ * 	  with the check byte last. A slot that was being written when the
+ * 	  power failed fails the check and the previous slot is used.
+ */
+
+/* Address of the cached region in the EEPROM */
+#define EE_BASE_ADDR 0u
+
+#define EE_COUNTERS_OFFSET EE_SETTINGS_SIZE
+
+/* Offsets of the fields within a counter slot */
+#define SLOT_SEQ 0u
+#define SLOT_VALUE_LOW 1u
+#define SLOT_VALUE_HIGH 2u
+#define SLOT_CHECK 3u
+
+static uint8_t cache[EE_CACHE_SIZE];
+static volatile uint8_t dirty[(EE_CACHE_SIZE + 7u) / 8u];
+
+/* Slot holding the current value of every counter */
+static uint8_t counter_slot[EE_COUNTERS];
+
+static uint8_t
+EE_eeprom_read_byte (uint16_t addr)
+{
+	/* Wait for the completion of a possible previous write */
+	while (EECR & (1<<EEWE))
+		;
+
+	EEAR = addr;
+	EECR |= (1<<EERE);
+
+	return EEDR;
+}
+
+static inline uint8_t
+EE_slot_offset (uint8_t id, uint8_t slot)
+{
+	return EE_COUNTERS_OFFSET +
+	       (id * EE_COUNTER_SLOTS + slot) * EE_COUNTER_SLOT_SIZE;
+}
+
+static inline uint8_t
+EE_slot_check (const uint8_t *slot)
+{
+	/* Inverted so that erased (0xFF) and zeroed slots are not valid */
+	return ~(slot[SLOT_SEQ] ^ slot[SLOT_VALUE_LOW] ^ slot[SLOT_VALUE_HIGH]);
+}
+
+static void
+EE_mark_dirty (uint8_t offset)
+{
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		dirty[offset >> 3] |= (1 << (offset & 7));
+
+		/* (Re-)enable the commit in the background */
+		EECR |= (1<<EERIE);
+	}
+}
+
+static inline _Bool
+EE_is_dirty (uint8_t offset)
+{
+	return dirty[offset >> 3] & (1 << (offset & 7));
+}
+
+/**
+ * EE_cache_update:
+ *
+ * Update a byte in the cache marking it dirty only if the value changes.
+ */
+static void
+EE_cache_update (uint8_t offset, uint8_t value)
+{
+	if (cache[offset] != value)
+	{
+		cache[offset] = value;
+		EE_mark_dirty (offset);
+	}
+}
+
+void
+EE_init (void)
+{
+	uint8_t offset = 0;
+	uint8_t id = 0;
+
+	for (; offset < EE_CACHE_SIZE; offset++)
+	{
+		cache[offset] = EE_eeprom_read_byte (EE_BASE_ADDR + offset);
+	}
+
+	for (offset = 0; offset < sizeof (dirty); offset++)
+	{
+		dirty[offset] = 0;
+	}
+
+	/* Locate the newest valid slot of every counter */
+	for (; id < EE_COUNTERS; id++)
+	{
+		uint8_t slot = 0;
+		_Bool found = 0;
+
+		counter_slot[id] = EE_COUNTER_SLOTS - 1;
+
+		for (; slot < EE_COUNTER_SLOTS; slot++)
+		{
+			const uint8_t *const curr = &cache[EE_slot_offset (id, slot)];
+			const uint8_t *const newest =
+				&cache[EE_slot_offset (id, counter_slot[id])];
+
+			if (curr[SLOT_CHECK] != EE_slot_check (curr))
+			{
+				continue;
+			}
+
+			/* Serial number arithmetic handles the wrap of the sequence */
+			if (!found || (int8_t) (curr[SLOT_SEQ] - newest[SLOT_SEQ]) > 0)
+			{
+				counter_slot[id] = slot;
+				found = 1;
+			}
+		}
+
+		if (!found)
+		{
+			/* Start afresh from a zero value in the first slot */
+			EE_counter_set (id, 0);
+		}
+	}
+}
+
+void
+EE_read (uint8_t addr, void *buf, uint8_t len)
+{
+	uint8_t *out = buf;
+
+	for (; len > 0 && addr < EE_SETTINGS_SIZE; len--)
+	{
+		*out++ = cache[addr++];
+	}
+}
+
+void
+EE_write (uint8_t addr, const void *buf, uint8_t len)
+{
+	const uint8_t *in = buf;
+
+	for (; len > 0 && addr < EE_SETTINGS_SIZE; len--)
+	{
+		EE_cache_update (addr++, *in++);
+	}
+}
+
+uint16_t
+EE_counter_get (uint8_t id)
+{
+	const uint8_t *const slot = &cache[EE_slot_offset (id, counter_slot[id])];
+
+	return slot[SLOT_VALUE_LOW] | (slot[SLOT_VALUE_HIGH] << 8);
+}
+
+void
+EE_counter_set (uint8_t id, uint16_t value)
+{
+	uint8_t base = EE_slot_offset (id, counter_slot[id]);
+	uint8_t seq = cache[base + SLOT_SEQ];
+
+	/*
+	 * Combine the writes if the current slot is yet to be committed.
+	 * Else move on to the next slot to spread the wear.
+	 */
+	if (!EE_is_dirty (base + SLOT_CHECK))
+	{
+		counter_slot[id] = (counter_slot[id] + 1) % EE_COUNTER_SLOTS;
+		base = EE_slot_offset (id, counter_slot[id]);
+		seq++;
+	}
+
+	EE_cache_update (base + SLOT_SEQ, seq);
+	EE_cache_update (base + SLOT_VALUE_LOW, value & 0xFF);
+	EE_cache_update (base + SLOT_VALUE_HIGH, value >> 8);
+
+	/*
+	 * Always mark the check byte dirty as it is used above to tell
+	 * whether the slot has been committed.
+	 */
+	cache[base + SLOT_CHECK] = EE_slot_check (&cache[base]);
+	EE_mark_dirty (base + SLOT_CHECK);
+}
+
+_Bool
+EE_busy (void)
+{
+	uint8_t index = 0;
+
+	if (EECR & (1<<EEWE))
+	{
+		return 1;
+	}
+
+	for (; index < sizeof (dirty); index++)
+	{
+		if (dirty[index])
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+void
+EE_flush (void)
+{
+	while (EE_busy())
+		;
+}
+
+/**
+ * Commit the next dirty byte whose value differs from the EEPROM.
+ *
+ * The interrupt is triggered continuously while the EEPROM is ready so it
+ * is disabled once there is nothing left to commit.
+ */
+ISR (EE_RDY_vect)
+{
+	uint8_t offset = 0;
+
+	for (; offset < EE_CACHE_SIZE; offset++)
+	{
+		const uint8_t mask = (1 << (offset & 7));
+
+		if (!(dirty[offset >> 3] & mask))
+		{
+			continue;
+		}
+
+		dirty[offset >> 3] &= ~mask;
+
+		if (EE_eeprom_read_byte (EE_BASE_ADDR + offset) == cache[offset])
+		{
+			continue;
+		}
+
+		EEAR = EE_BASE_ADDR + offset;
+		EEDR = cache[offset];
+
+		/*
+		 * EEWE has to be set within four cycles of setting EEMWE.
+		 * Done in assembly so that it holds regardless of the
+		 * optimisation level.
+		 */
+		__asm__ __volatile__ (
+			"sbi %0, %1" "\n\t"
+			"sbi %0, %2" "\n\t"
+			:
+			: "I" (_SFR_IO_ADDR (EECR)), "I" (EEMWE), "I" (EEWE)
+		);
+
+		return;
+	}
+
+	EECR &= ~(1<<EERIE);
+}
@@ -0,0 +1,130 @@
+#ifndef KS_EE_ATMEGA32
+#define KS_EE_ATMEGA32
+
+/**
+ * Write-back cached access to the internal EEPROM of the ATMEGA32.
+ *
+ * A region at the start of the EEPROM is mirrored in RAM. Reads are
+ * served from the RAM copy and writes only update the RAM copy and mark
+ * the bytes dirty. The dirty bytes are committed in the background by
+ * the EEPROM ready (EE_RDY) interrupt, one byte per interrupt, so none of
+ * the functions ever waits for the ~8.5ms taken by an EEPROM write.
+ * Bytes whose value in the EEPROM already matches are not written at all.
+ *
+ * Layout of the cached region:
+ *
+ * 	0 .. EE_SETTINGS_SIZE-1: settings (free format, byte addressed)
+ *
+ * 	EE_SETTINGS_SIZE ..: EE_COUNTERS wear leveled counters. Each counter
+ * 	                     rotates through EE_COUNTER_SLOTS slots so that
+ * 	                     every EEPROM cell sees only 1/EE_COUNTER_SLOTS
+ * 	                     of the writes.
+ *
+ * Notes:
+ *
+ * 1. Global interrupts have to be enabled for the commit to progress.
+ *
+ * 2. The region is not used by anything else. Code using eeprom_*
+ *    functions of avr-libc must stay clear of the first EE_CACHE_SIZE
+ *    bytes.
+ */
+
+#include <stdint.h>
+#include <avr/io.h>
+
+#define EE_SETTINGS_SIZE 16u
+
+#define EE_COUNTERS 2u
+#define EE_COUNTER_SLOTS 4u
+
+/*
+ * Size of the slot used for a counter:
+ *
+ * 	sequence number (1), value (2), check byte (1)
+ */
+#define EE_COUNTER_SLOT_SIZE 4u
+
+#define EE_CACHE_SIZE (EE_SETTINGS_SIZE + \
+                       EE_COUNTERS * EE_COUNTER_SLOTS * EE_COUNTER_SLOT_SIZE)
+
+/**
+ * EE_init:
+ *
+ * Load the cached region from the EEPROM and recover the current value
+ * of every counter.
+ *
+ * Note that this reads the EEPROM synchronously (a few cycles per byte)
+ * and has to be invoked before any other function.
+ */
+void
+EE_init (void);
+
+/**
+ * EE_read:
+ *
+ * @addr: offset of the byte in the settings area
+ * @buf: buffer used to return the bytes
+ * @len: number of bytes to read
+ *
+ * Read the settings from the RAM copy.
+ */
+void
+EE_read (uint8_t addr, void *buf, uint8_t len);
+
+/**
+ * EE_write:
+ *
+ * @addr: offset of the byte in the settings area
+ * @buf: the bytes to be written
+ * @len: number of bytes to write
+ *
+ * Update the settings in the RAM copy and schedule the changed bytes
+ * to be committed in the background. Repeated writes to a byte before
+ * it is committed result in a single EEPROM write.
+ *
+ * Bytes beyond the settings area are silently ignored.
+ */
+void
+EE_write (uint8_t addr, const void *buf, uint8_t len);
+
+/**
+ * EE_counter_get:
+ *
+ * @id: the counter (0 .. EE_COUNTERS-1)
+ *
+ * Returns: the current value of the counter.
+ */
+uint16_t
+EE_counter_get (uint8_t id);
+
+/**
+ * EE_counter_set:
+ *
+ * @id: the counter (0 .. EE_COUNTERS-1)
+ * @value: the new value of the counter
+ *
+ * Set the value of the counter. The value is written into the next
+ * slot of the counter unless the current slot is yet to be committed
+ * in which case the current slot is updated in place.
+ */
+void
+EE_counter_set (uint8_t id, uint16_t value);
+
+/**
+ * EE_busy:
+ *
+ * Returns: non-zero value if there are bytes yet to be committed.
+ */
+_Bool
+EE_busy (void);
+
+/**
+ * EE_flush:
+ *
+ * Wait till all the dirty bytes are committed. Intended to be used
+ * only before deliberately powering down or resetting.
+ */
+void
+EE_flush (void);
+
+#endif
@@ -0,0 +1,33 @@
+/**
+ * Program to test the write-back cached EEPROM.
+ *
+ * Counts the number of resets in a wear leveled counter and shows
+ * the count on PORTB.
+ *
+ * PORTB - output (count of resets)
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "../ee/ee.h"
+
+int main (void)
+{
+	static const uint8_t boot_counter = 0;
+
+	DDRB = 0xFF;
+
+	EE_init ();
+
+	/* Interrupts are required for the commit to progress */
+	sei ();
+
+	EE_counter_set (boot_counter, EE_counter_get (boot_counter) + 1);
+
+	/* The counter is committed in the background */
+	PORTB = EE_counter_get (boot_counter) & 0xFF;
+
+	while (1)
+	{
+	}
+}
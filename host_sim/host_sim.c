@@ -0,0 +1,82 @@
+/**
+ * Program to run the I2C/RTC and the LCD drivers on the host against
+ * the simulated pins and record their waveforms.
+ *
+ * Writes the transitions of the lines to a VCD file (the first argument,
+ * drivers.vcd by default) which could be viewed with any waveform viewer
+ * (e.g. GTKWave) and prints the timing measurements. The output is
+ * deterministic so the measurements of two builds could be diffed.
+ *
+ * Sequence:
+ *
+ * 	1. RTC_init followed by reading the time and the date
+ * 	2. An access to an absent slave (NACK)
+ * 	3. initialize_lcd followed by writing both the lines
+ */
+
+#include <stdio.h>
+#include "sim/sim.h"
+#include "sim/ds1307.h"
+#include "sim/timing.h"
+#include "../i2c_rtc/i2c/i2c.h"
+#include "../i2c_rtc/rtc/rtc.h"
+#include "../lcd_display/lcd/lcd.h"
+
+static void
+run_rtc (void)
+{
+	struct RTC_time time = { {0}, {0}, {0} };
+	struct RTC_date date = { {0}, {0}, {0}, {0} };
+
+	if (RTC_init () || RTC_read_time (&time) || RTC_read_date (&date))
+	{
+		printf ("RTC: ACK failure\n");
+		return;
+	}
+
+	printf ("RTC: %02x:%02x:%02x %02x/%02x/%02x\n",
+	        time.hours.register_val, time.minutes.register_val,
+	        time.seconds.register_val, date.date.register_val,
+	        date.month.register_val, date.year.register_val);
+
+	/* No slave at this address */
+	I2C_start ();
+	printf ("Absent slave: %s\n", I2C_send (0xA0) ? "NACK" : "ACK");
+	I2C_stop ();
+}
+
+static void
+run_lcd (void)
+{
+	static const char line_1[] = "Hello world!";
+	static const char line_2[] = "!dlrow olleH";
+
+	DDRD = 0xFF;
+	DDRA |= 0x07;
+
+	initialize_lcd ();
+	lcd_write_at (1, 0, line_1, sizeof (line_1) - 1);
+	lcd_write_at (2, 0, line_2, sizeof (line_2) - 1);
+}
+
+int
+main (int argc, char *argv[])
+{
+	const char *const path = (argc > 1) ? argv[1] : "drivers.vcd";
+
+	if (SIM_trace_open (path))
+	{
+		perror (path);
+		return 1;
+	}
+
+	run_rtc ();
+	run_lcd ();
+
+	SIM_trace_close ();
+
+	printf ("Simulated %lu cycles\n", (unsigned long) SIM_cycles ());
+	SIM_timing_report ();
+
+	return 0;
+}
@@ -0,0 +1,21 @@
+#ifndef KS_HOST_SIM_AVR_IO
+#define KS_HOST_SIM_AVR_IO
+
+/**
+ * Registers of the ATMEGA32 used by the drivers, as simulated on the host.
+ *
+ * Every access to a register goes through SIM_reg which advances the
+ * simulated cycle clock and records the transitions of the pins (see
+ * sim/sim.h).
+ */
+
+#include "../../sim/sim.h"
+
+#define PINA (*SIM_reg (SIM_PINA))
+#define DDRA (*SIM_reg (SIM_DDRA))
+#define PORTA (*SIM_reg (SIM_PORTA))
+#define PIND (*SIM_reg (SIM_PIND))
+#define DDRD (*SIM_reg (SIM_DDRD))
+#define PORTD (*SIM_reg (SIM_PORTD))
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef KS_HOST_SIM_AVR_PGMSPACE
+#define KS_HOST_SIM_AVR_PGMSPACE
+
+/* The host has a single address space; the flash is just constant data */
+
+#include <stdint.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t *) (addr))
+#define pgm_read_word(addr) (*(const uint16_t *) (addr))
+
+#endif
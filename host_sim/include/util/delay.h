@@ -0,0 +1,16 @@
+#ifndef KS_HOST_SIM_UTIL_DELAY
+#define KS_HOST_SIM_UTIL_DELAY
+
+/*
+ * The busy waits advance the simulated cycle clock instead. They are
+ * defined in sim/sim.c (rather than inline as in avr-libc) along with
+ * the rest of the cycle accounting.
+ */
+
+void
+_delay_us (double us);
+
+void
+_delay_ms (double ms);
+
+#endif
@@ -0,0 +1,178 @@
+#include "ds1307.h"
+
+#define SLAVE_ADDR 0x68u
+
+enum SIM_ds1307_state
+{
+	/* Waiting for a start condition */
+	STATE_IDLE,
+
+	/* Receiving the slave address */
+	STATE_ADDRESS,
+
+	/* Receiving the register pointer */
+	STATE_POINTER,
+
+	/* Receiving the values of the registers */
+	STATE_WRITE,
+
+	/* Sending the values of the registers */
+	STATE_READ
+};
+
+static uint8_t registers[SIM_DS1307_REGISTERS];
+static uint8_t pointer = 0;
+
+static enum SIM_ds1307_state state = STATE_IDLE;
+
+/* Rising edges of SCL in the current byte (9 including the ACK) */
+static uint8_t clocks = 0;
+
+static uint8_t shift = 0;
+static _Bool pulls_sda = 0;
+
+/* Whether the byte is acknowledged (by the slave or the master) */
+static _Bool acked = 0;
+
+uint8_t *
+SIM_ds1307_registers (void)
+{
+	return registers;
+}
+
+_Bool
+SIM_ds1307_pulls_sda (void)
+{
+	return pulls_sda;
+}
+
+/**
+ * SIM_ds1307_received:
+ *
+ * Handle a byte received from the master.
+ *
+ * Returns: whether the byte is to be acknowledged.
+ */
+static _Bool
+SIM_ds1307_received (uint8_t byte)
+{
+	switch (state)
+	{
+		case STATE_ADDRESS:
+			if ((byte >> 1) != SLAVE_ADDR)
+			{
+				state = STATE_IDLE;
+				return 0;
+			}
+
+			state = (byte & 1) ? STATE_READ : STATE_POINTER;
+			return 1;
+
+		case STATE_POINTER:
+			pointer = byte % SIM_DS1307_REGISTERS;
+			state = STATE_WRITE;
+			return 1;
+
+		case STATE_WRITE:
+			registers[pointer] = byte;
+			pointer = (pointer + 1) % SIM_DS1307_REGISTERS;
+			return 1;
+
+		default:
+			return 0;
+	}
+}
+
+/**
+ * SIM_ds1307_load:
+ *
+ * Load the register at the pointer to be sent to the master.
+ */
+static void
+SIM_ds1307_load (void)
+{
+	shift = registers[pointer];
+	pointer = (pointer + 1) % SIM_DS1307_REGISTERS;
+}
+
+void
+SIM_ds1307_scl (uint8_t scl, uint8_t sda)
+{
+	if (state == STATE_IDLE)
+	{
+		return;
+	}
+
+	if (scl)
+	{
+		clocks++;
+
+		if (state == STATE_READ)
+		{
+			/* The master acknowledges during the 9th clock */
+			if (clocks == 9)
+			{
+				acked = !sda;
+			}
+		}
+		else if (clocks <= 8)
+		{
+			shift = (shift << 1) | sda;
+		}
+
+		return;
+	}
+
+	/* The slave changes SDA only while SCL is low */
+	if (clocks == 8)
+	{
+		if (state == STATE_READ)
+		{
+			/* Let the master acknowledge */
+			pulls_sda = 0;
+		}
+		else
+		{
+			acked = SIM_ds1307_received (shift);
+			pulls_sda = acked;
+		}
+	}
+	else if (clocks == 9)
+	{
+		const _Bool was_address = (state == STATE_READ && pulls_sda);
+
+		clocks = 0;
+		pulls_sda = 0;
+
+		if (state == STATE_READ)
+		{
+			/* Following the ACK of the address or of a byte read */
+			if (!was_address && !acked)
+			{
+				state = STATE_IDLE;
+				return;
+			}
+
+			SIM_ds1307_load ();
+			pulls_sda = !(shift & 0x80);
+		}
+	}
+	else if (state == STATE_READ && clocks > 0)
+	{
+		pulls_sda = !(shift & (0x80 >> clocks));
+	}
+}
+
+void
+SIM_ds1307_sda (uint8_t sda, uint8_t scl)
+{
+	if (!scl)
+	{
+		return;
+	}
+
+	/* SDA changing while SCL is high is a start or a stop condition */
+	state = sda ? STATE_IDLE : STATE_ADDRESS;
+	clocks = 0;
+	pulls_sda = 0;
+}
@@ -0,0 +1,52 @@
+#ifndef KS_HOST_SIM_DS1307
+#define KS_HOST_SIM_DS1307
+
+/**
+ * Bus-level model of the DS1307 as an I2C slave.
+ *
+ * Follows the SCL and SDA lines to decode the start and stop conditions
+ * and the bytes, acknowledges its address (0xD0/0xD1), keeps the
+ * register pointer and drives SDA to return the registers. The clock
+ * itself does not run; the registers hold whatever was last written.
+ */
+
+#include <stdint.h>
+
+#define SIM_DS1307_REGISTERS 64u
+
+/**
+ * SIM_ds1307_registers:
+ *
+ * Returns: the 64 registers (including the NVRAM) to be inspected or
+ *          preset.
+ */
+uint8_t *
+SIM_ds1307_registers (void);
+
+/**
+ * SIM_ds1307_scl:
+ *
+ * @scl: new level of SCL
+ * @sda: level of SDA
+ */
+void
+SIM_ds1307_scl (uint8_t scl, uint8_t sda);
+
+/**
+ * SIM_ds1307_sda:
+ *
+ * @sda: new level of SDA
+ * @scl: level of SCL
+ */
+void
+SIM_ds1307_sda (uint8_t sda, uint8_t scl);
+
+/**
+ * SIM_ds1307_pulls_sda:
+ *
+ * Returns: whether the slave drives SDA low.
+ */
+_Bool
+SIM_ds1307_pulls_sda (void);
+
+#endif
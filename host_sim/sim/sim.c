@@ -0,0 +1,245 @@
+#include <stdio.h>
+#include <util/delay.h>
+#include "sim.h"
+#include "sim_signals.h"
+#include "ds1307.h"
+#include "timing.h"
+
+#define SCL_PIN 6
+#define SDA_PIN 7
+#define EN_PIN 0
+#define RW_PIN 1
+#define RS_PIN 2
+
+static volatile uint8_t registers[SIM_REGISTERS];
+
+static uint32_t cycles = 0;
+
+/* Levels of the signals as last recorded */
+static uint8_t levels[SIM_SIGNALS];
+static _Bool levels_valid = 0;
+
+/* Whether the MCU and the slave were driving SDA against each other */
+static _Bool contending = 0;
+
+static FILE *vcd = NULL;
+static uint32_t vcd_time = UINT32_MAX;
+
+/* Identifiers of the signals in the VCD file */
+static const char vcd_ids[SIM_SIGNALS] = { '!', '"', '#', '$', '%', '&' };
+
+/**
+ * SIM_line:
+ *
+ * Returns: the level of a line of PORTA with a pull-up (an input is high).
+ */
+static uint8_t
+SIM_line (uint8_t pin)
+{
+	if (registers[SIM_DDRA] & (1<<pin))
+	{
+		return (registers[SIM_PORTA] >> pin) & 1;
+	}
+
+	return 1;
+}
+
+/**
+ * SIM_sample:
+ *
+ * Compute the levels of the signals from the registers and the slave.
+ */
+static void
+SIM_sample (uint8_t *out)
+{
+	const uint8_t sda_master = SIM_line (SDA_PIN);
+	const _Bool contention = sda_master && SIM_ds1307_pulls_sda ()
+	                         && (registers[SIM_DDRA] & (1<<SDA_PIN));
+
+	/*
+	 * Sampled again on every pass of SIM_sync till the levels settle;
+	 * only the start of a contention is counted.
+	 */
+	if (contention && !contending)
+	{
+		SIM_timing_contention ();
+	}
+
+	contending = contention;
+
+	out[SIM_SIGNAL_SCL] = SIM_line (SCL_PIN);
+	out[SIM_SIGNAL_SDA] = sda_master && !SIM_ds1307_pulls_sda ();
+	out[SIM_SIGNAL_EN] = (registers[SIM_PORTA] >> EN_PIN) & 1;
+	out[SIM_SIGNAL_RW] = (registers[SIM_PORTA] >> RW_PIN) & 1;
+	out[SIM_SIGNAL_RS] = (registers[SIM_PORTA] >> RS_PIN) & 1;
+	out[SIM_SIGNAL_DATA] = registers[SIM_PORTD];
+}
+
+static void
+SIM_vcd_value (uint8_t signal, uint8_t level)
+{
+	int8_t bit = 7;
+
+	if (vcd == NULL)
+	{
+		return;
+	}
+
+	if (vcd_time != cycles)
+	{
+		fprintf (vcd, "#%lu\n", (unsigned long) (cycles * SIM_NS_PER_CYCLE));
+		vcd_time = cycles;
+	}
+
+	if (signal != SIM_SIGNAL_DATA)
+	{
+		fprintf (vcd, "%u%c\n", level, vcd_ids[signal]);
+		return;
+	}
+
+	fputc ('b', vcd);
+	for (; bit >= 0; bit--)
+	{
+		fputc ('0' + ((level >> bit) & 1), vcd);
+	}
+	fprintf (vcd, " %c\n", vcd_ids[signal]);
+}
+
+/**
+ * SIM_sync:
+ *
+ * Record the transitions since the last sync at the current time. The
+ * slave could react to a transition of the bus by driving SDA so the
+ * levels are sampled again till they settle.
+ */
+static void
+SIM_sync (void)
+{
+	uint8_t now[SIM_SIGNALS];
+	uint8_t signal = 0;
+	_Bool changed = 1;
+
+	while (changed)
+	{
+		changed = 0;
+		SIM_sample (now);
+
+		for (signal = 0; signal < SIM_SIGNALS; signal++)
+		{
+			if (levels_valid && now[signal] == levels[signal])
+			{
+				continue;
+			}
+
+			levels[signal] = now[signal];
+			SIM_vcd_value (signal, now[signal]);
+
+			if (!levels_valid)
+			{
+				continue;
+			}
+
+			SIM_timing_event ((uint64_t) cycles * SIM_NS_PER_CYCLE, signal, now[signal]);
+
+			/* Report the edges of the bus one at a time to the slave */
+			if (signal == SIM_SIGNAL_SCL)
+			{
+				SIM_ds1307_scl (now[signal], levels[SIM_SIGNAL_SDA]);
+				changed = 1;
+				break;
+			}
+
+			if (signal == SIM_SIGNAL_SDA)
+			{
+				SIM_ds1307_sda (now[signal], levels[SIM_SIGNAL_SCL]);
+				changed = 1;
+				break;
+			}
+		}
+
+		levels_valid = 1;
+	}
+}
+
+volatile uint8_t *
+SIM_reg (enum SIM_register reg)
+{
+	SIM_sync ();
+	cycles += SIM_ACCESS_CYCLES;
+
+	if (reg == SIM_PINA)
+	{
+		/* Outputs read back as driven; inputs as the lines are */
+		registers[SIM_PINA] = (registers[SIM_PORTA] & registers[SIM_DDRA]) |
+		                      ~registers[SIM_DDRA];
+		registers[SIM_PINA] &= ~(1<<SDA_PIN);
+		registers[SIM_PINA] |= levels[SIM_SIGNAL_SDA] << SDA_PIN;
+	}
+
+	return &registers[reg];
+}
+
+uint32_t
+SIM_cycles (void)
+{
+	return cycles;
+}
+
+void
+_delay_us (double us)
+{
+	SIM_sync ();
+	cycles += (uint32_t) (us * (SIM_F_CPU / 1000000.0) + 0.5);
+}
+
+void
+_delay_ms (double ms)
+{
+	_delay_us (ms * 1000.0);
+}
+
+int8_t
+SIM_trace_open (const char *path)
+{
+	static const char *const names[SIM_SIGNALS] = {
+		"scl", "sda", "lcd_en", "lcd_rw", "lcd_rs", "lcd_data"
+	};
+	uint8_t signal = 0;
+
+	vcd = fopen (path, "w");
+	if (vcd == NULL)
+	{
+		return 1;
+	}
+
+	fprintf (vcd, "$timescale 1ns $end\n$scope module atmega32 $end\n");
+
+	for (signal = 0; signal < SIM_SIGNALS; signal++)
+	{
+		fprintf (vcd, "$var wire %u %c %s $end\n",
+		         (signal == SIM_SIGNAL_DATA) ? 8 : 1, vcd_ids[signal],
+		         names[signal]);
+	}
+
+	fprintf (vcd, "$upscope $end\n$enddefinitions $end\n");
+
+	/* Dump the initial levels */
+	levels_valid = 0;
+	vcd_time = UINT32_MAX;
+	SIM_sync ();
+
+	return 0;
+}
+
+void
+SIM_trace_close (void)
+{
+	SIM_sync ();
+
+	if (vcd != NULL)
+	{
+		fprintf (vcd, "#%lu\n", (unsigned long) (cycles * SIM_NS_PER_CYCLE));
+		fclose (vcd);
+		vcd = NULL;
+	}
+}
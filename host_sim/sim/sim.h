@@ -0,0 +1,86 @@
+#ifndef KS_HOST_SIM
+#define KS_HOST_SIM
+
+/**
+ * Simulation of the pins used by the I2C (i2c_rtc/i2c) and the LCD
+ * (lcd_display/lcd) drivers on the host.
+ *
+ * Cycle clock:
+ *
+ * 	The clock advances by SIM_ACCESS_CYCLES on every access to a
+ * 	register and by the requested time in the busy waits. The code in
+ * 	between is taken to be free so the timings are those of an ideal
+ * 	build; the real ones could only be longer (see the DSO captures in
+ * 	i2c_rtc/dso_output).
+ *
+ * Pins:
+ *
+ * 	PORTA 6 (SCL), 7 (SDA) - the bus levels with the pull-ups: a line
+ * 	                         is high unless it is driven low by the
+ * 	                         MCU or the slave (see ds1307.h)
+ * 	PORTA 0 (EN), 1 (RW), 2 (RS) - control lines of the LCD
+ * 	PORTD - data bus of the LCD
+ *
+ * Every transition is written to a VCD file and passed on to the timing
+ * checks (see timing.h).
+ */
+
+#include <stdint.h>
+
+#define SIM_F_CPU 1000000ul
+#define SIM_NS_PER_CYCLE (1000000000ul / SIM_F_CPU)
+
+/* Cost of an in/out (or a read-modify-write) of a register */
+#define SIM_ACCESS_CYCLES 2u
+
+enum SIM_register
+{
+	SIM_PINA,
+	SIM_DDRA,
+	SIM_PORTA,
+	SIM_PIND,
+	SIM_DDRD,
+	SIM_PORTD,
+	SIM_REGISTERS
+};
+
+/**
+ * SIM_reg:
+ *
+ * @reg: the register being accessed
+ *
+ * Record the transitions caused by the previous access and advance the
+ * clock.
+ *
+ * Returns: the location of the register.
+ */
+volatile uint8_t *
+SIM_reg (enum SIM_register reg);
+
+/**
+ * SIM_cycles:
+ *
+ * Returns: the cycles since the start of the simulation.
+ */
+uint32_t
+SIM_cycles (void);
+
+/**
+ * SIM_trace_open:
+ *
+ * @path: the VCD file to be written
+ *
+ * Returns: 0 on success. Non-zero value if the file could not be created.
+ */
+int8_t
+SIM_trace_open (const char *path);
+
+/**
+ * SIM_trace_close:
+ *
+ * Record the last transitions and close the VCD file.
+ */
+void
+SIM_trace_close (void);
+
+#endif
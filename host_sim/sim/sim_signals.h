@@ -0,0 +1,13 @@
+#ifndef KS_HOST_SIM_SIGNALS
+#define KS_HOST_SIM_SIGNALS
+
+/* Signals traced by the simulation */
+#define SIM_SIGNAL_SCL 0u
+#define SIM_SIGNAL_SDA 1u
+#define SIM_SIGNAL_EN 2u
+#define SIM_SIGNAL_RW 3u
+#define SIM_SIGNAL_RS 4u
+#define SIM_SIGNAL_DATA 5u
+#define SIM_SIGNALS 6u
+
+#endif
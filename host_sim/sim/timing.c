@@ -0,0 +1,219 @@
+#include <stdio.h>
+#include "timing.h"
+#include "sim_signals.h"
+
+#define NONE UINT64_MAX
+
+/**
+ * SIM_timing_stat:
+ *
+ * @name: name of the parameter
+ * @spec_ns: the minimum required (0 if only the value is of interest)
+ * @min, @max, @total, @count: the values measured in ns
+ */
+struct SIM_timing_stat
+{
+	const char *name;
+	uint32_t spec_ns;
+	uint64_t min;
+	uint64_t max;
+	uint64_t total;
+	uint32_t count;
+};
+
+enum
+{
+	STAT_SCL_PERIOD,
+	STAT_SCL_HIGH,
+	STAT_SCL_LOW,
+	STAT_DATA_SETUP,
+	STAT_DATA_HOLD,
+	STAT_START_HOLD,
+	STAT_STOP_SETUP,
+	STAT_EN_WIDTH,
+	STAT_LCD_DATA_SETUP,
+	STAT_RS_SETUP,
+	STATS
+};
+
+static struct SIM_timing_stat stats[STATS] = {
+	[STAT_SCL_PERIOD] = { "SCL period", 10000, NONE, 0, 0, 0 },
+	[STAT_SCL_HIGH] = { "SCL high (tHIGH)", 4000, NONE, 0, 0, 0 },
+	[STAT_SCL_LOW] = { "SCL low (tLOW)", 4700, NONE, 0, 0, 0 },
+	[STAT_DATA_SETUP] = { "SDA setup (tSU;DAT)", 250, NONE, 0, 0, 0 },
+	[STAT_DATA_HOLD] = { "SDA hold (tHD;DAT)", 0, NONE, 0, 0, 0 },
+	[STAT_START_HOLD] = { "START hold (tHD;STA)", 4000, NONE, 0, 0, 0 },
+	[STAT_STOP_SETUP] = { "STOP setup (tSU;STO)", 4000, NONE, 0, 0, 0 },
+	[STAT_EN_WIDTH] = { "EN pulse width (PWEH)", 450, NONE, 0, 0, 0 },
+	[STAT_LCD_DATA_SETUP] = { "LCD data setup (tDSW)", 195, NONE, 0, 0, 0 },
+	[STAT_RS_SETUP] = { "RS setup (tAS)", 140, NONE, 0, 0, 0 }
+};
+
+static uint32_t contentions = 0;
+
+/* Time of the last transition of every signal */
+static uint64_t last_change[SIM_SIGNALS] = { NONE, NONE, NONE, NONE, NONE, NONE };
+
+static uint8_t scl = 1, sda = 1;
+
+/* Whether SDA changed since the last falling edge of SCL */
+static _Bool sda_changed_low = 0;
+
+/* Time of the last rising edge of SCL */
+static uint64_t last_scl_rise = NONE;
+
+/* Time of the last start condition */
+static uint64_t last_start = NONE;
+
+static void
+SIM_timing_add (uint8_t stat, uint64_t from, uint64_t to)
+{
+	struct SIM_timing_stat *const s = &stats[stat];
+	const uint64_t ns = to - from;
+
+	if (from == NONE || ns > SIM_TIMING_IDLE_NS)
+	{
+		return;
+	}
+
+	if (ns < s->min)
+	{
+		s->min = ns;
+	}
+
+	if (ns > s->max)
+	{
+		s->max = ns;
+	}
+
+	s->total += ns;
+	s->count++;
+}
+
+static void
+SIM_timing_i2c (uint64_t ns, uint8_t signal, uint8_t level)
+{
+	if (signal == SIM_SIGNAL_SCL)
+	{
+		if (level)
+		{
+			SIM_timing_add (STAT_SCL_PERIOD, last_scl_rise, ns);
+			SIM_timing_add (STAT_SCL_LOW, last_change[SIM_SIGNAL_SCL], ns);
+
+			if (sda_changed_low)
+			{
+				SIM_timing_add (STAT_DATA_SETUP, last_change[SIM_SIGNAL_SDA], ns);
+			}
+
+			last_scl_rise = ns;
+		}
+		else
+		{
+			SIM_timing_add (STAT_SCL_HIGH, last_change[SIM_SIGNAL_SCL], ns);
+			SIM_timing_add (STAT_START_HOLD, last_start, ns);
+
+			last_start = NONE;
+			sda_changed_low = 0;
+		}
+
+		scl = level;
+		return;
+	}
+
+	if (scl)
+	{
+		if (level)
+		{
+			SIM_timing_add (STAT_STOP_SETUP, last_change[SIM_SIGNAL_SCL], ns);
+		}
+		else
+		{
+			last_start = ns;
+		}
+	}
+	else if (!sda_changed_low)
+	{
+		SIM_timing_add (STAT_DATA_HOLD, last_change[SIM_SIGNAL_SCL], ns);
+		sda_changed_low = 1;
+	}
+
+	sda = level;
+}
+
+static void
+SIM_timing_lcd (uint64_t ns, uint8_t signal, uint8_t level)
+{
+	if (signal != SIM_SIGNAL_EN)
+	{
+		return;
+	}
+
+	if (level)
+	{
+		SIM_timing_add (STAT_RS_SETUP, last_change[SIM_SIGNAL_RS], ns);
+	}
+	else
+	{
+		/* The LCD latches the data bus on the falling edge of EN */
+		SIM_timing_add (STAT_EN_WIDTH, last_change[SIM_SIGNAL_EN], ns);
+		SIM_timing_add (STAT_LCD_DATA_SETUP, last_change[SIM_SIGNAL_DATA], ns);
+	}
+}
+
+void
+SIM_timing_event (uint64_t ns, uint8_t signal, uint8_t level)
+{
+	if (signal == SIM_SIGNAL_SCL || signal == SIM_SIGNAL_SDA)
+	{
+		SIM_timing_i2c (ns, signal, level);
+	}
+	else
+	{
+		SIM_timing_lcd (ns, signal, level);
+	}
+
+	last_change[signal] = ns;
+}
+
+void
+SIM_timing_contention (void)
+{
+	contentions++;
+}
+
+void
+SIM_timing_report (void)
+{
+	uint8_t stat = 0;
+
+	if (stats[STAT_SCL_PERIOD].count > 0)
+	{
+		const struct SIM_timing_stat *const period = &stats[STAT_SCL_PERIOD];
+
+		printf ("SCL frequency: max %lu Hz, mean %lu Hz\n",
+		        1000000000ul / period->min,
+		        (unsigned long) (1000000000ull * period->count / period->total));
+	}
+
+	printf ("%-24s %10s %10s %10s %10s %8s\n",
+	        "parameter", "min (ns)", "max (ns)", "spec (ns)", "margin", "count");
+
+	for (stat = 0; stat < STATS; stat++)
+	{
+		const struct SIM_timing_stat *const s = &stats[stat];
+
+		if (s->count == 0)
+		{
+			printf ("%-24s %10s\n", s->name, "-");
+			continue;
+		}
+
+		printf ("%-24s %10lu %10lu %10lu %10ld %8lu%s\n", s->name,
+		        (unsigned long) s->min, (unsigned long) s->max,
+		        (unsigned long) s->spec_ns,
+		        (long) s->min - (long) s->spec_ns, (unsigned long) s->count,
+		        (s->min < s->spec_ns) ? "  VIOLATION" : "");
+	}
+
+	printf ("SDA contentions: %lu\n", (unsigned long) contentions);
+}
@@ -0,0 +1,45 @@
+#ifndef KS_HOST_SIM_TIMING
+#define KS_HOST_SIM_TIMING
+
+/**
+ * Checks of the timing of the I2C and the LCD lines against the
+ * minimums of the I2C standard mode and the HD44780.
+ *
+ * For every parameter the smallest value seen is reported along with its
+ * margin (value - minimum); a negative margin is a violation. Intervals
+ * longer than SIM_TIMING_IDLE_NS are gaps between the transfers and are
+ * not accounted.
+ */
+
+#include <stdint.h>
+
+#define SIM_TIMING_IDLE_NS 1000000ul
+
+/**
+ * SIM_timing_event:
+ *
+ * @ns: time of the transition
+ * @signal: the signal (SIM_SIGNAL_*, see sim_signals.h)
+ * @level: the new level (the value for the data bus)
+ */
+void
+SIM_timing_event (uint64_t ns, uint8_t signal, uint8_t level);
+
+/**
+ * SIM_timing_contention:
+ *
+ * Count an instant when the MCU starts driving SDA high while the slave
+ * pulls it low (once per contention, however long it lasts).
+ */
+void
+SIM_timing_contention (void);
+
+/**
+ * SIM_timing_report:
+ *
+ * Print the measurements to the standard output.
+ */
+void
+SIM_timing_report (void);
+
+#endif
@@ -0,0 +1,348 @@
+#include <stddef.h>
+#include "alarm.h"
+
+#define NONE 0xFFu
+
+/* Longest jump of the time that is caught up with second by second */
+#define MAX_CATCH_UP 60u
+
+struct ALARM_entry
+{
+	/* NULL when the slot is free */
+	ALARM_fn fn;
+
+	/* Due time (binary) */
+	uint8_t hours, minutes, seconds;
+
+	_Bool daily;
+
+	/* Links of the bucket holding the alarm */
+	uint8_t *bucket;
+	uint8_t next, prev;
+};
+
+static struct ALARM_entry alarms[ALARM_MAX];
+
+static uint8_t seconds_wheel[60];
+static uint8_t minutes_wheel[60];
+static uint8_t hours_wheel[24];
+
+/* Time up to which the wheels have been advanced (binary) */
+static uint8_t now_hours, now_minutes, now_seconds;
+
+static inline uint8_t
+ALARM_bcd_to_bin (uint8_t bcd)
+{
+	return (bcd >> 4) * 10 + (bcd & 0x0F);
+}
+
+static void
+ALARM_link (uint8_t id, uint8_t *bucket)
+{
+	struct ALARM_entry *const alarm = &alarms[id];
+
+	alarm->bucket = bucket;
+	alarm->prev = NONE;
+	alarm->next = *bucket;
+
+	if (*bucket != NONE)
+	{
+		alarms[*bucket].prev = id;
+	}
+
+	*bucket = id;
+}
+
+static void
+ALARM_unlink (uint8_t id)
+{
+	struct ALARM_entry *const alarm = &alarms[id];
+
+	if (alarm->prev != NONE)
+	{
+		alarms[alarm->prev].next = alarm->next;
+	}
+	else
+	{
+		*alarm->bucket = alarm->next;
+	}
+
+	if (alarm->next != NONE)
+	{
+		alarms[alarm->next].prev = alarm->prev;
+	}
+
+	alarm->bucket = NULL;
+}
+
+/**
+ * ALARM_place:
+ *
+ * @id: the alarm
+ * @include_now: whether an alarm at the current second is due now
+ *               (rather than on the next day)
+ *
+ * Put the alarm in the finest bucket that covers its due time.
+ */
+static void
+ALARM_place (uint8_t id, _Bool include_now)
+{
+	const struct ALARM_entry *const alarm = &alarms[id];
+
+	if (alarm->hours == now_hours && alarm->minutes == now_minutes &&
+	    (alarm->seconds > now_seconds ||
+	     (include_now && alarm->seconds == now_seconds)))
+	{
+		ALARM_link (id, &seconds_wheel[alarm->seconds]);
+	}
+	else if (alarm->hours == now_hours && alarm->minutes > now_minutes)
+	{
+		ALARM_link (id, &minutes_wheel[alarm->minutes]);
+	}
+	else
+	{
+		/* Later in the day or on the next day */
+		ALARM_link (id, &hours_wheel[alarm->hours]);
+	}
+}
+
+/**
+ * ALARM_cascade:
+ *
+ * Move the alarms of a bucket to the finer wheels as per the current time.
+ */
+static void
+ALARM_cascade (uint8_t *bucket)
+{
+	while (*bucket != NONE)
+	{
+		const uint8_t id = *bucket;
+
+		ALARM_unlink (id);
+		ALARM_place (id, 1);
+	}
+}
+
+/**
+ * ALARM_fire:
+ *
+ * Invoke the callbacks of the alarms due in the current second.
+ */
+static void
+ALARM_fire (void)
+{
+	uint8_t *const bucket = &seconds_wheel[now_seconds];
+
+	/*
+	 * The head of the bucket is looked up again after every callback
+	 * as it could cancel (or add) alarms.
+	 */
+	while (*bucket != NONE)
+	{
+		const uint8_t id = *bucket;
+		struct ALARM_entry *const alarm = &alarms[id];
+		const ALARM_fn fn = alarm->fn;
+
+		ALARM_unlink (id);
+
+		if (alarm->daily)
+		{
+			/* Due at the same time on the next day */
+			ALARM_place (id, 0);
+		}
+		else
+		{
+			alarm->fn = NULL;
+		}
+
+		fn ();
+	}
+}
+
+/**
+ * ALARM_advance:
+ *
+ * Move the wheels forward by a second.
+ */
+static void
+ALARM_advance (void)
+{
+	if (++now_seconds == 60)
+	{
+		now_seconds = 0;
+
+		if (++now_minutes == 60)
+		{
+			now_minutes = 0;
+
+			if (++now_hours == 24)
+			{
+				now_hours = 0;
+			}
+
+			ALARM_cascade (&hours_wheel[now_hours]);
+		}
+
+		ALARM_cascade (&minutes_wheel[now_minutes]);
+	}
+
+	ALARM_fire ();
+}
+
+static void
+ALARM_set_now (const struct RTC_time *now)
+{
+	now_hours = ALARM_bcd_to_bin (now->hours.register_val & 0x3F);
+	now_minutes = ALARM_bcd_to_bin (now->minutes.register_val);
+	now_seconds = ALARM_bcd_to_bin (now->seconds.register_val & 0x7F);
+}
+
+static inline uint32_t
+ALARM_seconds_of_day (uint8_t hours, uint8_t minutes, uint8_t seconds)
+{
+	return (uint32_t) hours * 3600u + minutes * 60u + seconds;
+}
+
+void
+ALARM_init (const struct RTC_time *now)
+{
+	uint8_t index = 0;
+
+	for (; index < ALARM_MAX; index++)
+	{
+		alarms[index].fn = NULL;
+	}
+
+	for (index = 0; index < 60; index++)
+	{
+		seconds_wheel[index] = NONE;
+		minutes_wheel[index] = NONE;
+	}
+
+	for (index = 0; index < 24; index++)
+	{
+		hours_wheel[index] = NONE;
+	}
+
+	ALARM_set_now (now);
+}
+
+/**
+ * ALARM_add:
+ *
+ * Returns: id of a new alarm due at the given (binary) time or -1.
+ */
+static int8_t
+ALARM_add (uint8_t hours, uint8_t minutes, uint8_t seconds,
+           ALARM_fn fn, _Bool daily)
+{
+	int8_t id = 0;
+
+	for (; id < ALARM_MAX; id++)
+	{
+		struct ALARM_entry *const alarm = &alarms[id];
+
+		if (alarm->fn != NULL)
+		{
+			continue;
+		}
+
+		alarm->fn = fn;
+		alarm->hours = hours;
+		alarm->minutes = minutes;
+		alarm->seconds = seconds;
+		alarm->daily = daily;
+
+		ALARM_place (id, 0);
+
+		return id;
+	}
+
+	return -1;
+}
+
+int8_t
+ALARM_at (const struct RTC_time *when, ALARM_fn fn, _Bool daily)
+{
+	return ALARM_add (ALARM_bcd_to_bin (when->hours.register_val & 0x3F),
+	                  ALARM_bcd_to_bin (when->minutes.register_val),
+	                  ALARM_bcd_to_bin (when->seconds.register_val & 0x7F),
+	                  fn, daily);
+}
+
+int8_t
+ALARM_after (uint16_t seconds, ALARM_fn fn)
+{
+	uint32_t due = 0;
+
+	if (seconds == 0)
+	{
+		return -1;
+	}
+
+	due = (ALARM_seconds_of_day (now_hours, now_minutes, now_seconds) + seconds)
+	      % 86400u;
+
+	return ALARM_add (due / 3600u, (due / 60u) % 60u, due % 60u, fn, 0);
+}
+
+void
+ALARM_cancel (int8_t id)
+{
+	if (id < 0 || id >= ALARM_MAX || alarms[id].fn == NULL)
+	{
+		return;
+	}
+
+	if (alarms[id].bucket != NULL)
+	{
+		ALARM_unlink (id);
+	}
+
+	alarms[id].fn = NULL;
+}
+
+void
+ALARM_tick (const struct RTC_time *now)
+{
+	const uint32_t from = ALARM_seconds_of_day (now_hours, now_minutes,
+	                                            now_seconds);
+	uint32_t to = 0;
+	uint32_t elapsed = 0;
+	uint8_t id = 0;
+
+	ALARM_set_now (now);
+	to = ALARM_seconds_of_day (now_hours, now_minutes, now_seconds);
+	elapsed = (to + 86400u - from) % 86400u;
+
+	if (elapsed <= MAX_CATCH_UP)
+	{
+		/* Go back to where the wheels were and advance second by second */
+		now_hours = from / 3600u;
+		now_minutes = (from / 60u) % 60u;
+		now_seconds = from % 60u;
+
+		for (; elapsed > 0; elapsed--)
+		{
+			ALARM_advance ();
+		}
+
+		return;
+	}
+
+	/*
+	 * The time was set; put every alarm in its bucket afresh. The new
+	 * second is arrived at just as by ALARM_advance, so an alarm at
+	 * exactly the new time is due now and not on the next day.
+	 */
+	for (; id < ALARM_MAX; id++)
+	{
+		if (alarms[id].fn != NULL && alarms[id].bucket != NULL)
+		{
+			ALARM_unlink (id);
+			ALARM_place (id, 1);
+		}
+	}
+
+	ALARM_fire ();
+}
@@ -0,0 +1,103 @@
+#ifndef KS_RTC_ALARM
+#define KS_RTC_ALARM
+
+/**
+ * Alarms keyed on the time of the RTC, e.g. "at 06:30:00" or "after 90
+ * seconds".
+ *
+ * The alarms are kept in a hierarchical timer wheel with buckets for
+ * the seconds (60), minutes (60) and hours (24) of a day:
+ *
+ * 	- An alarm due within the current minute is put in the bucket of
+ * 	  its second; one due within the current hour in the bucket of its
+ * 	  minute; the rest in the bucket of their hour.
+ *
+ * 	- When a new hour (minute) begins, the alarms in its bucket are
+ * 	  moved down to the minutes (seconds) wheel.
+ *
+ * 	- Every second, the alarms in the bucket of the second are due.
+ *
+ * The buckets are doubly linked lists so adding and cancelling an alarm
+ * take constant time, and the work done every second depends only on
+ * the alarms that are moved or due, not on the number of alarms.
+ *
+ * ALARM_tick has to be invoked (from the main line) with the current
+ * time whenever it changes, e.g. on every edge of the 1Hz square wave
+ * (see clock/clock.h). The callbacks are invoked from ALARM_tick.
+ *
+ * Notes:
+ *
+ * 1. An alarm at a time that is not later than the current time today
+ *    is due on the next day.
+ *
+ * 2. Only the 24-hour mode of the RTC is supported.
+ */
+
+#include <stdint.h>
+#include "../rtc/rtc.h"
+
+#define ALARM_MAX 8
+
+typedef void (*ALARM_fn) (void);
+
+/**
+ * ALARM_init:
+ *
+ * @now: the current time
+ *
+ * Remove all the alarms and set the current time.
+ */
+void
+ALARM_init (const struct RTC_time *now);
+
+/**
+ * ALARM_at:
+ *
+ * @when: the time of the alarm
+ * @fn: the function to be invoked
+ * @daily: whether the alarm repeats every day
+ *
+ * Returns: id of the alarm (used to cancel it) or -1 if there is no
+ *          free slot.
+ */
+int8_t
+ALARM_at (const struct RTC_time *when, ALARM_fn fn, _Bool daily);
+
+/**
+ * ALARM_after:
+ *
+ * @seconds: delay from the current time (1 - 65535)
+ * @fn: the function to be invoked
+ *
+ * Returns: id of the alarm (used to cancel it) or -1 if there is no
+ *          free slot or the delay is 0.
+ */
+int8_t
+ALARM_after (uint16_t seconds, ALARM_fn fn);
+
+/**
+ * ALARM_cancel:
+ *
+ * @id: the id of the alarm
+ *
+ * Cancel the alarm. Could also be invoked from a callback.
+ */
+void
+ALARM_cancel (int8_t id);
+
+/**
+ * ALARM_tick:
+ *
+ * @now: the current time
+ *
+ * Advance the wheels up to the given time one second at a time,
+ * invoking the callbacks of the alarms that are due. If the time has
+ * jumped backwards or by more than a minute (e.g. the RTC was set), the
+ * alarms are put in the buckets again as per the new time instead: the
+ * ones at exactly the new time are invoked and the ones skipped over
+ * are due on the next day.
+ */
+void
+ALARM_tick (const struct RTC_time *now);
+
+#endif
@@ -0,0 +1,199 @@
+#include <stddef.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include "clock.h"
+#include "../../scheduler/seqlock/seqlock.h"
+#include "../../scheduler/power/power.h"
+
+static struct RTC_time curr_time;
+static struct RTC_date curr_date;
+
+static volatile uint8_t seq = 0;
+static volatile uint8_t seconds = 0;
+
+static inline uint8_t
+CLOCK_bcd_to_bin (uint8_t bcd)
+{
+	return (bcd >> 4) * 10 + (bcd & 0x0F);
+}
+
+static inline uint8_t
+CLOCK_bcd_increment (uint8_t bcd)
+{
+	bcd++;
+
+	/* Carry into the tens digit */
+	if ((bcd & 0x0F) == 0x0A)
+	{
+		bcd += 0x06;
+	}
+
+	return bcd;
+}
+
+/**
+ * CLOCK_days_in_month:
+ *
+ * Returns: number of days in the month (BCD month and year 2000 - 2099).
+ */
+static uint8_t
+CLOCK_days_in_month (uint8_t month, uint8_t year)
+{
+	static const uint8_t days[12] = {
+		31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31
+	};
+	const uint8_t month_bin = CLOCK_bcd_to_bin (month);
+
+	if (month_bin == 0 || month_bin > 12)
+	{
+		return 31;
+	}
+
+	if (month_bin == 2 && (CLOCK_bcd_to_bin (year) & 3) == 0)
+	{
+		return 29;
+	}
+
+	return days[month_bin - 1];
+}
+
+/**
+ * CLOCK_advance_date:
+ *
+ * Move the date to the next day.
+ */
+static void
+CLOCK_advance_date (struct RTC_date *date)
+{
+	date->dow.register_val = (date->dow.register_val >= 7) ? 1 :
+	                         date->dow.register_val + 1;
+
+	if (CLOCK_bcd_to_bin (date->date.register_val) <
+	    CLOCK_days_in_month (date->month.register_val, date->year.register_val))
+	{
+		date->date.register_val = CLOCK_bcd_increment (date->date.register_val);
+		return;
+	}
+
+	date->date.register_val = 0x01;
+
+	if (date->month.register_val < 0x12)
+	{
+		date->month.register_val = CLOCK_bcd_increment (date->month.register_val);
+		return;
+	}
+
+	date->month.register_val = 0x01;
+	date->year.register_val = (date->year.register_val == 0x99) ? 0x00 :
+	                          CLOCK_bcd_increment (date->year.register_val);
+}
+
+/**
+ * CLOCK_advance:
+ *
+ * Move the time forward by a second.
+ */
+static void
+CLOCK_advance (struct RTC_time *time, struct RTC_date *date)
+{
+	time->seconds.register_val = CLOCK_bcd_increment (time->seconds.register_val);
+	if (time->seconds.register_val < 0x60)
+	{
+		return;
+	}
+
+	time->seconds.register_val = 0x00;
+	time->minutes.register_val = CLOCK_bcd_increment (time->minutes.register_val);
+	if (time->minutes.register_val < 0x60)
+	{
+		return;
+	}
+
+	time->minutes.register_val = 0x00;
+	time->hours.register_val = CLOCK_bcd_increment (time->hours.register_val);
+	if (time->hours.register_val < 0x24)
+	{
+		return;
+	}
+
+	time->hours.register_val = 0x00;
+	CLOCK_advance_date (date);
+}
+
+/**
+ * The DS1307 updates its registers on the falling edge of the 1Hz SQW.
+ */
+ISR (INT2_vect)
+{
+	SEQLOCK_write_begin (&seq);
+	CLOCK_advance (&curr_time, &curr_date);
+	SEQLOCK_write_end (&seq);
+
+	seconds++;
+
+	/* The main line has a new second to handle */
+	POWER_notify ();
+}
+
+void
+CLOCK_set (const struct RTC_time *time, const struct RTC_date *date)
+{
+	/* The ISR is the writer otherwise; keep it out while writing here */
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		SEQLOCK_write_begin (&seq);
+		curr_time = *time;
+		curr_date = *date;
+		SEQLOCK_write_end (&seq);
+	}
+}
+
+int8_t
+CLOCK_init (const struct RTC_time *time, const struct RTC_date *date)
+{
+	CLOCK_set (time, date);
+
+	if (RTC_set_control (RTC_CONTROL_SQWE | RTC_CONTROL_RATE_1HZ))
+	{
+		return 1;
+	}
+
+	/* SQW/OUT is open drain; input with the pull-up enabled */
+	DDRB &= ~(1<<PB2);
+	PORTB |= (1<<PB2);
+
+	/* Falling edge of INT2 (ISC2 = 0) */
+	GICR &= ~(1<<INT2);
+	MCUCSR &= ~(1<<ISC2);
+	GIFR = (1<<INTF2);
+	GICR |= (1<<INT2);
+
+	return 0;
+}
+
+void
+CLOCK_snapshot (struct RTC_time *time, struct RTC_date *date)
+{
+	uint8_t start = 0;
+
+	do
+	{
+		start = SEQLOCK_read_begin (&seq);
+
+		if (time != NULL)
+		{
+			*time = curr_time;
+		}
+
+		if (date != NULL)
+		{
+			*date = curr_date;
+		}
+	} while (SEQLOCK_read_retry (&seq, start));
+}
+
+uint8_t
+CLOCK_seconds (void)
+{
+	return seconds;
+}
@@ -0,0 +1,83 @@
+#ifndef KS_RTC_CLOCK
+#define KS_RTC_CLOCK
+
+/**
+ * A copy of the time and date of the RTC kept in the RAM and advanced
+ * by an interrupt on every edge of the 1Hz square wave of the DS1307.
+ *
+ * The time is read from the RTC once (by the caller) and then the clock
+ * runs without any I2C communication. The values are kept in the same
+ * BCD register format as 'struct RTC_time' and 'struct RTC_date'.
+ *
+ * Readers get a consistent snapshot using a sequence counter (see
+ * scheduler/seqlock/seqlock.h): the interrupt never waits and a reader
+ * that overlaps an update simply copies the values again.
+ *
+ * Pins:
+ *
+ * 	PB2 (INT2) - SQW/OUT of the DS1307 (the internal pull-up is
+ * 	             enabled as the output is open drain)
+ *
+ * Notes:
+ *
+ * 1. The clock handles the 24-hour mode only (as set by RTC_init).
+ *
+ * 2. Global interrupts have to be enabled for the clock to run.
+ *
+ * 3. Every second is notified to the sleep manager (see POWER_notify in
+ *    scheduler/power/power.h), so power.c and sched.c have to be linked
+ *    as well.
+ */
+
+#include <stdint.h>
+#include <avr/io.h>
+#include "../rtc/rtc.h"
+
+/**
+ * CLOCK_init:
+ *
+ * @time: the current time read from the RTC
+ * @date: the current date read from the RTC
+ *
+ * Load the clock and start advancing it on the falling edges of SQW.
+ * Also configures the SQW of the RTC for 1Hz.
+ *
+ * Returns: 0 on success. Non-zero value in case of I2C failure.
+ */
+int8_t
+CLOCK_init (const struct RTC_time *time, const struct RTC_date *date);
+
+/**
+ * CLOCK_set:
+ *
+ * @time: the new time
+ * @date: the new date
+ *
+ * Replace the values of the clock (e.g. after reading the RTC again).
+ */
+void
+CLOCK_set (const struct RTC_time *time, const struct RTC_date *date);
+
+/**
+ * CLOCK_snapshot:
+ *
+ * @time: used to return the time (could be NULL)
+ * @date: used to return the date (could be NULL)
+ *
+ * Get a consistent copy of the time and date without disabling the
+ * interrupts.
+ */
+void
+CLOCK_snapshot (struct RTC_time *time, struct RTC_date *date);
+
+/**
+ * CLOCK_seconds:
+ *
+ * Returns: number of seconds (edges of SQW) since CLOCK_init. Wraps
+ *          around every 256 seconds; meant to detect that the clock
+ *          has advanced.
+ */
+uint8_t
+CLOCK_seconds (void);
+
+#endif
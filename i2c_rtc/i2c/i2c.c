@@ -1,5 +1,6 @@
 #define F_CPU 1000000ul
 #include <util/delay.h>
+#include <stddef.h>
 #include "i2c.h"
 
 /**
@@ -53,9 +54,28 @@
 #define SDA_OUTPUT() DDR |= (1<<SDA_PIN)
 #define SCL_OUTPUT() DDR |= (1<<SCL_PIN)
 
-typedef void (*delay) (double period);
+/**
+ * I2C_delay:
+ *
+ * @period: one of the periods defined above
+ *
+ * The default wait. The argument of _delay_us has to be a compile time
+ * constant so each of the periods used is waited for separately.
+ */
+static void
+I2C_delay (uint8_t period)
+{
+	if (period >= CLK_HIGH_PERIOD)
+	{
+		_delay_us (CLK_HIGH_PERIOD);
+	}
+	else
+	{
+		_delay_us (CLK_HALF_HIGH_PERIOD);
+	}
+}
 
-static delay delay_fn = _delay_us;
+static I2C_delay_fn delay_fn = I2C_delay;
 
 inline void
 I2C_init (void)
@@ -69,6 +89,12 @@ I2C_init (void)
 	SDA_HIGH ();
 }
 
+void
+I2C_set_delay (I2C_delay_fn fn)
+{
+	delay_fn = (fn != NULL) ? fn : I2C_delay;
+}
+
 /**
  * I2C_start_stop_helper:
  *
@@ -304,3 +330,15 @@ I2C_receive (uint8_t ack_to_send)
 
 	return incoming_byte;
 }
+
+uint8_t
+I2C_receive_unacked (void)
+{
+	return I2C_receive_byte ();
+}
+
+void
+I2C_acknowledge (uint8_t ack_to_send)
+{
+	I2C_send_ack (ack_to_send);
+}
@@ -53,6 +53,19 @@
 #define I2C_ACK_ACK 0u
 #define I2C_ACK_NACK 1u
 
+/**
+ * I2C_delay_fn:
+ *
+ * Function used by the library to wait for the given period (in whole
+ * us, at most I2C_MAX_DELAY_US) between the changes of the SCL and SDA
+ * lines. The period is an integer so that a replacement could look up
+ * the wait without any floating point arithmetic.
+ */
+typedef void (*I2C_delay_fn) (uint8_t period);
+
+/* Longest period for which the library waits (half the clock period) */
+#define I2C_MAX_DELAY_US 10u
+
 /**
  * I2C_init:
  *
@@ -113,4 +126,40 @@ I2C_send (uint8_t byte);
 uint8_t
 I2C_receive (uint8_t ack_to_send);
 
+/**
+ * I2C_receive_unacked:
+ *
+ * Receive a byte from the I2C channel without sending the ACK. Allows
+ * the caller to decide whether to continue the transfer based on the
+ * value received.
+ *
+ * Note: Must be followed by I2C_acknowledge.
+ */
+uint8_t
+I2C_receive_unacked (void);
+
+/**
+ * I2C_acknowledge:
+ *
+ * @ack_to_send: the ack value to send (I2C_ACK_ACK or I2C_ACK_NACK)
+ *
+ * Send the ACK for the byte received using I2C_receive_unacked.
+ */
+void
+I2C_acknowledge (uint8_t ack_to_send);
+
+/**
+ * I2C_set_delay:
+ *
+ * @fn: the function to be used for the waits or NULL to restore the
+ *      default (based on _delay_us)
+ *
+ * Replace the function used to wait between the changes of the lines.
+ * Used to observe the lines while they are held (see i2c_capture.h).
+ *
+ * Note: Do not invoke in the middle of a transfer.
+ */
+void
+I2C_set_delay (I2C_delay_fn fn);
+
 #endif
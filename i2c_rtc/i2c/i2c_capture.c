@@ -0,0 +1,335 @@
+#include <stddef.h>
+#include "i2c_capture.h"
+
+/*
+ * An entry of the buffer:
+ *
+ * 	7: SDA
+ * 	6: SCL
+ * 	5-0: number of samples
+ *
+ * The lines are stored at the same positions as their pins so that a
+ * sample needs no shifting.
+ */
+#if SDA_PIN != 7 || SCL_PIN != 6
+#error "The capture expects SDA at pin 7 and SCL at pin 6"
+#endif
+
+#define LINES_MASK ((1<<SDA_PIN) | (1<<SCL_PIN))
+#define LINES_IDLE LINES_MASK
+#define RUN_MAX 0x3Fu
+
+#define SDA_LEVEL(lines) ((lines) & (1<<SDA_PIN))
+#define SCL_LEVEL(lines) ((lines) & (1<<SCL_PIN))
+
+/**
+ * I2C_decoder:
+ *
+ * State used to decode the changes of the lines. Used both to detect
+ * the trigger while sampling and to decode the buffer.
+ */
+struct I2C_decoder
+{
+	uint8_t lines;
+	uint8_t bit;
+	uint8_t byte;
+	_Bool in_transfer;
+	_Bool first_byte;
+};
+
+static uint8_t buffer[I2C_CAPTURE_SIZE];
+
+/* Index of the next entry and number of valid entries */
+static uint8_t head = 0;
+static uint8_t count = 0;
+
+/* The run in progress */
+static uint8_t run_lines = LINES_IDLE;
+static uint8_t run = 0;
+
+static uint8_t trigger_type = I2C_CAPTURE_TRIGGER_START;
+static _Bool recording = 0, triggered = 0, frozen = 0;
+static uint8_t post_trigger = 0;
+
+static struct I2C_decoder live;
+
+static void
+I2C_decoder_init (struct I2C_decoder *decoder, uint8_t lines)
+{
+	decoder->lines = lines;
+	decoder->bit = 0;
+	decoder->byte = 0;
+	decoder->in_transfer = 0;
+	decoder->first_byte = 0;
+}
+
+/**
+ * I2C_decoder_step:
+ *
+ * @decoder: the decoder state
+ * @lines: the new level of the lines
+ * @record: used to return the decoded record
+ *
+ * Returns: whether a record was decoded.
+ */
+static _Bool
+I2C_decoder_step (struct I2C_decoder *decoder, uint8_t lines,
+                  struct I2C_capture_record *record)
+{
+	const uint8_t prev = decoder->lines;
+
+	decoder->lines = lines;
+
+	if (SCL_LEVEL (prev) && SCL_LEVEL (lines))
+	{
+		/* SDA changing while SCL is high is a START or a STOP */
+		if (SDA_LEVEL (prev) && !SDA_LEVEL (lines))
+		{
+			decoder->in_transfer = 1;
+			decoder->first_byte = 1;
+			decoder->bit = 0;
+			decoder->byte = 0;
+			record->type = I2C_CAPTURE_START;
+			return 1;
+		}
+
+		if (!SDA_LEVEL (prev) && SDA_LEVEL (lines))
+		{
+			decoder->in_transfer = 0;
+			record->type = I2C_CAPTURE_STOP;
+			return 1;
+		}
+
+		return 0;
+	}
+
+	/* SDA is sampled on the rising edge of SCL */
+	if (SCL_LEVEL (prev) || !SCL_LEVEL (lines) || !decoder->in_transfer)
+	{
+		return 0;
+	}
+
+	if (decoder->bit < 8)
+	{
+		decoder->byte = (decoder->byte << 1) | (SDA_LEVEL (lines) ? 1 : 0);
+		decoder->bit++;
+		return 0;
+	}
+
+	/* The 9th bit is the ACK */
+	record->type = (decoder->first_byte) ? I2C_CAPTURE_ADDR : I2C_CAPTURE_DATA;
+	record->value = decoder->byte;
+	record->ack = SDA_LEVEL (lines) ? I2C_ACK_NACK : I2C_ACK_ACK;
+
+	decoder->first_byte = 0;
+	decoder->bit = 0;
+	decoder->byte = 0;
+
+	return 1;
+}
+
+/**
+ * I2C_capture_flush:
+ *
+ * Append the run in progress to the buffer.
+ */
+static void
+I2C_capture_flush (void)
+{
+	if (!recording || frozen || run == 0)
+	{
+		return;
+	}
+
+	buffer[head] = run_lines | run;
+	head = (head + 1) % I2C_CAPTURE_SIZE;
+
+	if (count < I2C_CAPTURE_SIZE)
+	{
+		count++;
+	}
+
+	if (trigger_type == I2C_CAPTURE_TRIGGER_START)
+	{
+		/* Do not overwrite the traffic following the START */
+		if (count == I2C_CAPTURE_SIZE)
+		{
+			frozen = 1;
+		}
+	}
+	else if (triggered && --post_trigger == 0)
+	{
+		frozen = 1;
+	}
+}
+
+/**
+ * I2C_capture_change:
+ *
+ * Check the trigger on a change of the lines.
+ */
+static void
+I2C_capture_change (uint8_t lines)
+{
+	struct I2C_capture_record record;
+
+	if (!I2C_decoder_step (&live, lines, &record) || triggered)
+	{
+		return;
+	}
+
+	if (trigger_type == I2C_CAPTURE_TRIGGER_START &&
+	    record.type == I2C_CAPTURE_START)
+	{
+		/* The run before the START is kept so the START can be decoded */
+		recording = 1;
+		triggered = 1;
+
+		if (run == 0)
+		{
+			run = 1;
+		}
+	}
+	else if (trigger_type == I2C_CAPTURE_TRIGGER_NACK &&
+	         (record.type == I2C_CAPTURE_ADDR ||
+	          record.type == I2C_CAPTURE_DATA) &&
+	         record.ack == I2C_ACK_NACK)
+	{
+		triggered = 1;
+		post_trigger = I2C_CAPTURE_SIZE / 2;
+	}
+}
+
+static inline void
+I2C_capture_sample (void)
+{
+	const uint8_t lines = PIN & LINES_MASK;
+
+	if (lines == run_lines)
+	{
+		if (++run == RUN_MAX)
+		{
+			I2C_capture_flush ();
+			run = 0;
+		}
+
+		return;
+	}
+
+	I2C_capture_change (lines);
+	I2C_capture_flush ();
+
+	run_lines = lines;
+	run = 1;
+}
+
+/**
+ * I2C_capture_delay:
+ *
+ * Replacement for the wait function of the I2C library that samples
+ * the lines for the period.
+ */
+static void
+I2C_capture_delay (uint8_t period)
+{
+	uint8_t samples = period;
+
+	do
+	{
+		I2C_capture_sample ();
+	} while (samples-- > 1);
+}
+
+static void
+I2C_capture_reset (uint8_t trigger)
+{
+	head = count = 0;
+	run_lines = PIN & LINES_MASK;
+	run = 0;
+
+	trigger_type = trigger;
+	recording = (trigger == I2C_CAPTURE_TRIGGER_NACK);
+	triggered = 0;
+	frozen = 0;
+	post_trigger = 0;
+
+	I2C_decoder_init (&live, run_lines);
+}
+
+void
+I2C_capture_start (uint8_t trigger)
+{
+	I2C_capture_reset (trigger);
+	I2C_set_delay (I2C_capture_delay);
+}
+
+void
+I2C_capture_monitor (uint8_t trigger, uint16_t samples)
+{
+	const uint8_t ddr = DDR & LINES_MASK;
+	const uint8_t port = PORT & LINES_MASK;
+
+	/*
+	 * Release the lines: I2C_init and every transfer leave them driven
+	 * (or pulled up) which would corrupt the traffic being watched.
+	 */
+	DDR &= ~LINES_MASK;
+	PORT &= ~LINES_MASK;
+
+	I2C_capture_reset (trigger);
+
+	for (; samples > 0 && !frozen; samples--)
+	{
+		I2C_capture_sample ();
+	}
+
+	I2C_capture_flush ();
+
+	/* Restore the lines as they were */
+	PORT = (PORT & ~LINES_MASK) | port;
+	DDR = (DDR & ~LINES_MASK) | ddr;
+}
+
+void
+I2C_capture_stop (void)
+{
+	I2C_set_delay (NULL);
+	I2C_capture_flush ();
+	run = 0;
+}
+
+_Bool
+I2C_capture_done (void)
+{
+	return frozen;
+}
+
+uint8_t
+I2C_capture_decode (struct I2C_capture_record *records, uint8_t max_records)
+{
+	struct I2C_decoder decoder;
+	uint8_t index = (head + I2C_CAPTURE_SIZE - count) % I2C_CAPTURE_SIZE;
+	uint8_t remaining = count;
+	uint8_t decoded = 0;
+
+	if (remaining == 0)
+	{
+		return 0;
+	}
+
+	/* The oldest entry gives the initial level of the lines */
+	I2C_decoder_init (&decoder, buffer[index] & LINES_MASK);
+
+	for (; remaining > 0 && decoded < max_records; remaining--)
+	{
+		if (I2C_decoder_step (&decoder, buffer[index] & LINES_MASK,
+		                      &records[decoded]))
+		{
+			decoded++;
+		}
+
+		index = (index + 1) % I2C_CAPTURE_SIZE;
+	}
+
+	return decoded;
+}
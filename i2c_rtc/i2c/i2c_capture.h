@@ -0,0 +1,121 @@
+#ifndef KS_I2C_CAPTURE
+#define KS_I2C_CAPTURE
+
+/**
+ * A simple logic analyzer for the SCL and SDA lines of the I2C bus.
+ *
+ * The lines are sampled into a RAM buffer using run-length encoding:
+ * every entry holds the level of both the lines along with the number
+ * of successive samples (1 - 63) they stayed at that level. So a bus
+ * that is idle or held costs an entry per 63 samples.
+ *
+ * Sampling:
+ *
+ * 	- Own transfers: I2C_capture_start replaces the wait function of
+ * 	  the I2C library (see I2C_set_delay) with one that keeps sampling
+ * 	  the lines in a tight loop for the period of the wait. As the lines
+ * 	  change only before a wait, every change (including the ones made by
+ * 	  the slave) is captured. The bus runs slower while capturing as a
+ * 	  sample takes more than 1us.
+ *
+ * 	- Other masters: I2C_capture_monitor samples the lines in a tight
+ * 	  loop at the fastest possible rate.
+ *
+ * Triggers:
+ *
+ * 	- I2C_CAPTURE_TRIGGER_START: recording begins at the first START
+ * 	  condition and stops when the buffer is full.
+ *
+ * 	- I2C_CAPTURE_TRIGGER_NACK: recording goes on in a circular manner
+ * 	  and stops once half the buffer is filled after a NACK is seen.
+ * 	  So the buffer holds the traffic both before and after the NACK.
+ *
+ * The buffer is decoded into START/address/data/STOP records using
+ * I2C_capture_decode.
+ */
+
+#include <stdint.h>
+#include "i2c.h"
+
+#define I2C_CAPTURE_SIZE 128u
+
+/* Triggers */
+#define I2C_CAPTURE_TRIGGER_START 0u
+#define I2C_CAPTURE_TRIGGER_NACK 1u
+
+/* Types of the decoded records */
+#define I2C_CAPTURE_START 0u
+#define I2C_CAPTURE_STOP 1u
+#define I2C_CAPTURE_ADDR 2u
+#define I2C_CAPTURE_DATA 3u
+
+/**
+ * I2C_capture_record:
+ *
+ * A decoded record. @value and @ack are valid only for the address and
+ * data records; @ack is I2C_ACK_ACK or I2C_ACK_NACK.
+ */
+struct I2C_capture_record
+{
+	uint8_t type;
+	uint8_t value;
+	uint8_t ack;
+};
+
+/**
+ * I2C_capture_start:
+ *
+ * @trigger: one of I2C_CAPTURE_TRIGGER_*
+ *
+ * Clear the buffer and start capturing the transfers done using the
+ * I2C library.
+ */
+void
+I2C_capture_start (uint8_t trigger);
+
+/**
+ * I2C_capture_monitor:
+ *
+ * @trigger: one of I2C_CAPTURE_TRIGGER_*
+ * @samples: maximum number of samples to take
+ *
+ * Clear the buffer and capture the transfers of another master on the
+ * bus. The lines are made inputs without the internal pull-ups for the
+ * capture (the bus needs its external pull-ups) and restored on return.
+ * No transfer of the I2C library must be in progress.
+ *
+ * Returns only after the recording stops or after @samples samples.
+ */
+void
+I2C_capture_monitor (uint8_t trigger, uint16_t samples);
+
+/**
+ * I2C_capture_stop:
+ *
+ * Stop capturing and restore the default wait function of the library.
+ */
+void
+I2C_capture_stop (void);
+
+/**
+ * I2C_capture_done:
+ *
+ * Returns: whether the recording has stopped due to the trigger.
+ */
+_Bool
+I2C_capture_done (void);
+
+/**
+ * I2C_capture_decode:
+ *
+ * @records: array used to return the decoded records
+ * @max_records: size of the array
+ *
+ * Decode the captured samples from the oldest to the newest.
+ *
+ * Returns: number of records decoded.
+ */
+uint8_t
+I2C_capture_decode (struct I2C_capture_record *records, uint8_t max_records);
+
+#endif
@@ -0,0 +1,122 @@
+/**
+ * Simple program to test the logic analyzer of the I2C lines.
+ *
+ * The read of the time from the RTC is captured and the decoded
+ * records are shown on the LCD:
+ *
+ * 	S  - START
+ * 	P  - STOP
+ * 	XXA - address or data byte (in hex) followed by the ACK
+ * 	      (A: ACK, N: NACK)
+ *
+ * e.g. "S D0A 00A S D1A 25A 59A 23N P" for 23:59:25.
+ *
+ * PORTB - output (LEDs, active low): all glow in case of I2C failure.
+ */
+
+#include <avr/io.h>
+
+#include "rtc/rtc.h"
+#include "i2c/i2c.h"
+#include "i2c/i2c_capture.h"
+#include "../lcd_display/lcd/lcd.h"
+
+#define MAX_RECORDS 16u
+#define LCD_COLS 16u
+
+/**
+ * format_record:
+ *
+ * @record: the decoded record
+ * @buf: used to return the text (at least 4 characters)
+ *
+ * Returns: the length of the text.
+ */
+static uint8_t
+format_record (const struct I2C_capture_record *record, char *buf)
+{
+	static const char hex[] = "0123456789ABCDEF";
+
+	switch (record->type)
+	{
+		case I2C_CAPTURE_START:
+			buf[0] = 'S';
+			return 1;
+
+		case I2C_CAPTURE_STOP:
+			buf[0] = 'P';
+			return 1;
+
+		default:
+			buf[0] = hex[record->value >> 4];
+			buf[1] = hex[record->value & 0x0F];
+			buf[2] = (record->ack == I2C_ACK_ACK) ? 'A' : 'N';
+			return 3;
+	}
+}
+
+int
+main (void)
+{
+	struct I2C_capture_record records[MAX_RECORDS];
+	struct RTC_time time;
+	char text[2 * LCD_COLS];
+	uint8_t decoded = 0, len = 0, i = 0, j = 0;
+
+	/* Debug port */
+	DDRB = 0xFF;
+	PORTB = 0xFF;
+
+	/* Initialise the LCD */
+	DDRD = 0xFF;
+	DDRA |= 0x07;
+	initialize_lcd ();
+
+	I2C_init ();
+
+	/* Record from the START of the read till the buffer fills */
+	I2C_capture_start (I2C_CAPTURE_TRIGGER_START);
+
+	if (RTC_read_time (&time))
+	{
+		/* Glow all LEDs to indicate ACK failure */
+		PORTB = 0x00;
+	}
+
+	I2C_capture_stop ();
+
+	decoded = I2C_capture_decode (records, MAX_RECORDS);
+
+	/* Separate the records by a space and stop at the end of the LCD */
+	for (i = 0; i < decoded; i++)
+	{
+		char buf[4];
+		const uint8_t record_len = format_record (&records[i], buf);
+
+		if (len + record_len > sizeof (text))
+		{
+			break;
+		}
+
+		for (j = 0; j < record_len; j++)
+		{
+			text[len++] = buf[j];
+		}
+
+		if (len < sizeof (text))
+		{
+			text[len++] = ' ';
+		}
+	}
+
+	lcd_write_at (1, 0, text, (len < LCD_COLS) ? len : LCD_COLS);
+
+	if (len > LCD_COLS)
+	{
+		lcd_write_at (2, 0, text + LCD_COLS, len - LCD_COLS);
+	}
+
+	while (1);
+
+	return 0;
+}
@@ -0,0 +1,140 @@
+#include "nvlog.h"
+
+/* RAM copy of the NVRAM contents */
+static struct NVLOG_record records[NVLOG_SLOTS];
+
+/* Slot holding the newest record and its sequence number */
+static uint8_t newest_slot = NVLOG_SLOTS - 1;
+static uint8_t newest_seq = 0;
+
+/* Whether any valid record was found in the log */
+static _Bool log_empty = 1;
+
+/**
+ * NVLOG_check:
+ *
+ * Compute the check byte over all the bytes of the record preceding it.
+ *
+ * The value is seeded so that NVRAM filled with all zeros or all ones
+ * (as is possible after the backup battery was replaced) does not
+ * look like a valid record.
+ */
+static uint8_t
+NVLOG_check (const struct NVLOG_record *record)
+{
+	const uint8_t *byte = (const uint8_t *) record;
+	uint8_t check = 0xA5;
+	uint8_t count = offsetof (struct NVLOG_record, check);
+
+	for (; count > 0; count--)
+	{
+		/* rotate left and add the next byte */
+		check = (uint8_t) ((check << 1) | (check >> 7)) + *byte++;
+	}
+
+	return check;
+}
+
+static inline _Bool
+NVLOG_record_valid (const struct NVLOG_record *record)
+{
+	return record->check == NVLOG_check (record);
+}
+
+int8_t
+NVLOG_init (void)
+{
+	uint8_t slot = 0;
+
+	if (RTC_nvram_read (0, (uint8_t *) records, sizeof (records)))
+	{
+		return 1;
+	}
+
+	log_empty = 1;
+	newest_slot = NVLOG_SLOTS - 1;
+	newest_seq = 0;
+
+	for (; slot < NVLOG_SLOTS; slot++)
+	{
+		const struct NVLOG_record *const record = &records[slot];
+
+		if (!NVLOG_record_valid (record))
+		{
+			continue;
+		}
+
+		/*
+		 * Serial number arithmetic: the live sequence numbers are
+		 * never more than NVLOG_SLOTS apart so the sign of their
+		 * difference tells which one is newer even after a wrap.
+		 */
+		if (log_empty || (int8_t) (record->seq - newest_seq) > 0)
+		{
+			newest_slot = slot;
+			newest_seq = record->seq;
+			log_empty = 0;
+		}
+	}
+
+	return 0;
+}
+
+int8_t
+NVLOG_append (uint8_t tag, const uint8_t *payload)
+{
+	const uint8_t slot = (newest_slot + 1) % NVLOG_SLOTS;
+	struct NVLOG_record *const record = &records[slot];
+	uint8_t pos = 0;
+
+	record->seq = newest_seq + 1;
+	record->tag = tag;
+
+	for (; pos < NVLOG_PAYLOAD_SIZE; pos++)
+	{
+		record->payload[pos] = payload[pos];
+	}
+
+	record->check = NVLOG_check (record);
+
+	if (RTC_nvram_write (slot * sizeof (struct NVLOG_record),
+	                     (const uint8_t *) record, sizeof (struct NVLOG_record)))
+	{
+		/* Mark the RAM copy invalid as the NVRAM contents are unknown */
+		record->check = ~record->check;
+		return 1;
+	}
+
+	newest_slot = slot;
+	newest_seq = record->seq;
+	log_empty = 0;
+
+	return 0;
+}
+
+const struct NVLOG_record *
+NVLOG_latest (uint8_t tag)
+{
+	uint8_t slot = newest_slot;
+	uint8_t count = NVLOG_SLOTS;
+
+	if (log_empty)
+	{
+		return NULL;
+	}
+
+	/* Walk backwards from the newest record */
+	for (; count > 0; count--)
+	{
+		const struct NVLOG_record *const record = &records[slot];
+
+		if (NVLOG_record_valid (record) && record->tag == tag)
+		{
+			return record;
+		}
+
+		slot = (slot == 0) ? (NVLOG_SLOTS - 1) : (slot - 1);
+	}
+
+	return NULL;
+}
@@ -0,0 +1,98 @@
+#ifndef KS_RTC_NVLOG
+#define KS_RTC_NVLOG
+
+/**
+ * A small persistent log kept in the battery backed RAM of the DS1307.
+ *
+ * The NVRAM is split into fixed size slots that are used as a ring.
+ * Every record carries a sequence number and a check byte. The newest
+ * record is the valid one with the highest sequence number (compared
+ * using serial number arithmetic) so the state of the log can be
+ * recovered after a reset by a single burst read of the NVRAM.
+ *
+ * A record is written using a single burst. If the power fails in the
+ * middle of the write the check byte of the partially written record
+ * would not match and the record is ignored; the previous records remain
+ * intact.
+ *
+ * Unlike the EEPROM of the controller, the NVRAM does not wear out on
+ * writes so the log could be appended to as often as required.
+ *
+ * Note: The RTC has to be initialised (see RTC_init) before invoking any
+ *       of the functions.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../rtc/rtc.h"
+
+/**
+ * Tags identifying the kind of value held in a record.
+ */
+#define NVLOG_TAG_BOOT_COUNT   1u
+#define NVLOG_TAG_ERROR        2u
+#define NVLOG_TAG_SYNC_TIME    3u
+#define NVLOG_TAG_STARTUP_TIME 4u
+
+#define NVLOG_PAYLOAD_SIZE 4u
+
+/**
+ * NVLOG_record:
+ *
+ * Layout of a record as stored in the NVRAM.
+ */
+struct NVLOG_record
+{
+	uint8_t seq;
+	uint8_t tag;
+	uint8_t payload[NVLOG_PAYLOAD_SIZE];
+	uint8_t check;
+};
+
+/* 7 byte records: 8 slots fill the 56 bytes of the NVRAM exactly */
+#define NVLOG_SLOTS ((uint8_t) (RTC_NVRAM_SIZE / sizeof (struct NVLOG_record)))
+
+/**
+ * NVLOG_init:
+ *
+ * Recover the state of the log by reading the whole NVRAM in a
+ * single burst into a RAM copy and locating the newest record.
+ *
+ * Returns: 0 if the NVRAM could be read. Non-zero value in case of failure.
+ */
+int8_t
+NVLOG_init (void);
+
+/**
+ * NVLOG_append:
+ *
+ * @tag: the tag of the record
+ * @payload: NVLOG_PAYLOAD_SIZE bytes to be stored in the record
+ *
+ * Write a new record into the slot following the newest record,
+ * overwriting the oldest record once the log is full.
+ *
+ * Note: The log holds only the last NVLOG_SLOTS records regardless of
+ *       their tags. A value that must survive should be appended again
+ *       (e.g. at every boot) so that it does not get overwritten.
+ *
+ * Returns: 0 if the record was written. Non-zero value in case of failure.
+ */
+int8_t
+NVLOG_append (uint8_t tag, const uint8_t *payload);
+
+/**
+ * NVLOG_latest:
+ *
+ * @tag: the tag of the record to look for
+ *
+ * Find the newest record with the given tag from the RAM copy of the
+ * log. No I2C communication is done.
+ *
+ * Returns: pointer to the record or NULL if there is no record with
+ *          the given tag.
+ */
+const struct NVLOG_record *
+NVLOG_latest (uint8_t tag);
+
+#endif
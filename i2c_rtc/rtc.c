@@ -4,22 +4,207 @@
  */
 
 #include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
 
 /* Debug */
 #define F_CPU 1000000UL
 #include <util/delay.h>
+#include <util/delay_basic.h>
 
 #include "rtc/rtc.h"
+#include "nvlog/nvlog.h"
 #include "../lcd_display/lcd/lcd.h"
+#include "../lcd_display/lcd/lcd_async.h"
+#include "../lcd_display/lcd/lcd_format.h"
+#include "../scheduler/sched/sched.h"
+#include "../memory/mem/mem.h"
+#include "i2c/i2c.h"
+
+#ifdef SCHED_XTAL_TICK
+
+/* Iterations of _delay_loop_2 for each of the periods (in us) */
+static uint16_t delay_loops[I2C_MAX_DELAY_US + 1];
+
+/**
+ * calibrate_delays:
+ *
+ * Compute the iterations of the waits from the CPU clock measured by
+ * SCHED_calibrate (rather than the nominal F_CPU) once, so that nothing
+ * but a look up is left for the waits themselves.
+ */
+static void
+calibrate_delays (void)
+{
+	const uint16_t cycles_per_ms = SCHED_calibrate ();
+	uint8_t period = 0;
+
+	for (period = 0; period <= I2C_MAX_DELAY_US; period++)
+	{
+		/* 4 cycles per iteration; round up to never be short */
+		const uint16_t loops = ((uint32_t) period * cycles_per_ms + 3999u) / 4000u;
+
+		/* 0 iterations would be taken as 65536 */
+		delay_loops[period] = (loops > 0) ? loops : 1;
+	}
+}
+
+/**
+ * calibrated_delay_us:
+ *
+ * @period: the time to wait in us
+ *
+ * Busy wait for @period us of the crystal.
+ */
+static void
+calibrated_delay_us (uint8_t period)
+{
+	_delay_loop_2 (delay_loops[(period <= I2C_MAX_DELAY_US) ? period : I2C_MAX_DELAY_US]);
+}
+
+#endif
+
+/**
+ * log_boot:
+ *
+ * Increment the boot count kept in the NVRAM log of the RTC.
+ *
+ * Returns: 0 on success. Non-zero value in case of I2C failure.
+ */
+static int8_t
+log_boot (void)
+{
+	const struct NVLOG_record *last_boot = NULL;
+	uint8_t payload[NVLOG_PAYLOAD_SIZE] = { 0 };
+	uint16_t boot_count = 0;
+
+	if (NVLOG_init())
+	{
+		return 1;
+	}
+
+	last_boot = NVLOG_latest (NVLOG_TAG_BOOT_COUNT);
+	if (last_boot != NULL)
+	{
+		boot_count = last_boot->payload[0] | (last_boot->payload[1] << 8);
+	}
+
+	boot_count++;
+	payload[0] = boot_count & 0xFF;
+	payload[1] = boot_count >> 8;
+
+	return NVLOG_append (NVLOG_TAG_BOOT_COUNT, payload);
+}
+
+/**
+ * rtc_startup:
+ *
+ * @time: used to return the time read from the RTC
+ * @date: used to return the date read from the RTC
+ *
+ * Bring up the RTC as a coroutine so that it could be done during the
+ * power-on waits of the LCD: initialise the registers and read the time
+ * and date to be shown first. Every step yields to the LCD after at most
+ * one short burst (RTC_init, ~3ms, is the longest). The boot is recorded
+ * only after the first display as reading the NVRAM log alone (a 56 byte
+ * burst, ~14ms) takes most of the 20ms power-on wait of the LCD.
+ *
+ * Returns: PT_WAITING till the bring-up is complete, then PT_DONE or
+ *          PT_ERROR in case of I2C failure.
+ */
+static int8_t
+rtc_startup (struct RTC_time *time, struct RTC_date *date)
+{
+	static uint16_t lc = 0;
+	static struct RTC_pt rtc_pt;
+	int8_t status = PT_WAITING;
+
+	PT_BEGIN (lc);
+
+	if (RTC_init())
+	{
+		PT_EXIT (lc, PT_ERROR);
+	}
+
+#ifdef SCHED_XTAL_TICK
+	PT_YIELD (lc);
+
+	/* The ticks of the scheduler don't advance without the square wave */
+	if (RTC_set_control (RTC_CONTROL_SQWE | RTC_CONTROL_RATE_32768HZ))
+	{
+		PT_EXIT (lc, PT_ERROR);
+	}
+#endif
+
+	PT_YIELD (lc);
+
+	RTC_pt_init (&rtc_pt);
+	PT_WAIT_UNTIL (lc, (status = RTC_read_time_async (&rtc_pt, time)) != PT_WAITING);
+	if (status == PT_ERROR)
+	{
+		PT_EXIT (lc, PT_ERROR);
+	}
+
+	RTC_pt_init (&rtc_pt);
+	PT_WAIT_UNTIL (lc, (status = RTC_read_date_async (&rtc_pt, date)) != PT_WAITING);
+	if (status == PT_ERROR)
+	{
+		PT_EXIT (lc, PT_ERROR);
+	}
+
+	PT_END (lc);
+}
+
+/*
+ * Change of the startup time (in ms) worth a new record; smaller ones
+ * are the jitter of the 1ms ticks the time is measured in.
+ */
+#define STARTUP_TIME_TOLERANCE_MS 2u
+
+/**
+ * log_startup_time:
+ *
+ * @ms: time from the start of the bring-up till the first display
+ *
+ * Record the time taken to show the first time and date in the NVRAM log.
+ * A record (a burst write of the RTC and a slot of the log) is spent only
+ * when the time differs from the one already logged by more than
+ * STARTUP_TIME_TOLERANCE_MS, so that the boot records are not pushed out
+ * of the log by the same value every boot.
+ *
+ * Returns: 0 on success. Non-zero value in case of I2C failure.
+ */
+static int8_t
+log_startup_time (uint16_t ms)
+{
+	const struct NVLOG_record *const last = NVLOG_latest (NVLOG_TAG_STARTUP_TIME);
+	const uint8_t payload[NVLOG_PAYLOAD_SIZE] = { ms & 0xFF, ms >> 8, 0, 0 };
+
+	if (last != NULL)
+	{
+		const uint16_t last_ms = last->payload[0] | (last->payload[1] << 8);
+		const uint16_t change = (ms > last_ms) ? ms - last_ms : last_ms - ms;
+
+		if (change <= STARTUP_TIME_TOLERANCE_MS)
+		{
+			return 0;
+		}
+	}
+
+	return NVLOG_append (NVLOG_TAG_STARTUP_TIME, payload);
+}
 
 /**
  * Functions used to display the time and date in the required format[1].
- * The functions use the required LCD commands as and when required.
+ * The text is composed in a buffer and written to the LCD in one pass.
  *
  * [1]: Required format:
  *
  * 		Time: HH:MM:SS
  * 		Date: DD/MM/YY DOW
+ *
+ * The rest of the lines show the stack usage (see display_stack_usage)
+ * and the startup time (see display_startup_time).
  */
 
 /**
@@ -27,28 +212,32 @@
  *
  * (@time): the structure containing the values in the RTC registers
  *
- * Display the time in the LCD in the required format (see above).
+ * Display the time in the first line of the LCD in the required format
+ * (see above).
  */
 void
 display_time (struct RTC_time time)
 {
-	/* Display the hours */
-	lcd_data (time.hours.positions.tens_pos + '0');
-	lcd_data (time.hours.positions.ones_pos + '0');
+	struct lcd_format fmt;
+
+	lcd_format_init (&fmt);
+
+	/* Display the hours (bit 6 selects the 12-hour mode) */
+	lcd_format_bcd (&fmt, time.hours.register_val & 0x3F);
 
 	/* Hour-Minutes separator */
-	lcd_data (':');
+	lcd_format_char (&fmt, ':');
 
 	/* Display the minutes */
-	lcd_data (time.minutes.positions.tens_pos + '0');
-	lcd_data (time.minutes.positions.ones_pos + '0');
+	lcd_format_bcd (&fmt, time.minutes.register_val & 0x7F);
 
 	/* Minutes-Seconds separator */
-	lcd_data (':');
+	lcd_format_char (&fmt, ':');
+
+	/* Display the seconds (bit 7 is the clock halt flag) */
+	lcd_format_bcd (&fmt, time.seconds.register_val & 0x7F);
 
-	/* Display the seconds */
-	lcd_data (time.seconds.positions.tens_pos + '0' );
-	lcd_data (time.seconds.positions.ones_pos + '0' );
+	lcd_format_flush (&fmt, 1, 0);
 }
 
 /**
@@ -56,12 +245,13 @@ display_time (struct RTC_time time)
  *
  * (@date): the structure containing the values in the RTC registers
  *
- * Display the date in the LCD in the required format (see above).
+ * Display the date in the second line of the LCD in the required format
+ * (see above).
  */
 void
 display_date (struct RTC_date date)
 {
-	static const char dow_strings[8][3] = {
+	static const char dow_strings[8][3] PROGMEM = {
 		"",
 		"MON",
 		"TUE",
@@ -72,49 +262,191 @@ display_date (struct RTC_date date)
 		"SUN"
 	};
 	const char *const curr_dow = dow_strings [date.dow.positions.ones_pos];
+	struct lcd_format fmt;
+
+	lcd_format_init (&fmt);
 
 	/* Display the date */
-	lcd_data (date.date.positions.tens_pos + '0');
-	lcd_data (date.date.positions.ones_pos + '0');
+	lcd_format_bcd (&fmt, date.date.register_val & 0x3F);
 
 	/* Date-Month separator */
-	lcd_data ('/');
+	lcd_format_char (&fmt, '/');
 
 	/* Display the month */
-	lcd_data (date.month.positions.tens_pos + '0');
-	lcd_data (date.month.positions.ones_pos + '0');
+	lcd_format_bcd (&fmt, date.month.register_val & 0x1F);
 
 	/* Month-Year separator */
-	lcd_data ('/');
+	lcd_format_char (&fmt, '/');
 
 	/* Display the year */
-	lcd_data (date.year.positions.tens_pos + '0');
-	lcd_data (date.year.positions.ones_pos + '0');
+	lcd_format_bcd (&fmt, date.year.register_val);
 
 	/* Year-DOW separator */
-	lcd_data (' ');
+	lcd_format_char (&fmt, ' ');
 
 	/* Display the day of the week */
-	lcd_data (*(curr_dow + 0));
-	lcd_data (*(curr_dow + 1));
-	lcd_data (*(curr_dow + 2));
+	lcd_format_char (&fmt, pgm_read_byte (curr_dow + 0));
+	lcd_format_char (&fmt, pgm_read_byte (curr_dow + 1));
+	lcd_format_char (&fmt, pgm_read_byte (curr_dow + 2));
+
+	lcd_format_flush (&fmt, 2, 0);
+}
+
+/**
+ * display_stack_usage:
+ *
+ * Display the most bytes of the stack used since the reset at the end
+ * of the first line, to watch the headroom of the SRAM.
+ */
+static void
+display_stack_usage (void)
+{
+	struct lcd_format fmt;
+
+	lcd_format_init (&fmt);
+	lcd_format_uint (&fmt, MEM_stack_high_water (), 5, ' ');
+	lcd_format_flush (&fmt, 1, 11);
+}
+
+/**
+ * display_startup_time:
+ *
+ * @ms: time from the start of the bring-up till the first display
+ *
+ * Display the time taken to show the first time and date at the end of
+ * the second line (after the day of the week), saturated at 999ms.
+ */
+static void
+display_startup_time (uint16_t ms)
+{
+	struct lcd_format fmt;
+
+	lcd_format_init (&fmt);
+	lcd_format_uint (&fmt, (ms > 999) ? 999 : ms, 3, ' ');
+	lcd_format_flush (&fmt, 2, 13);
+}
+
+/**
+ * count_fine_ticks:
+ *
+ * @total: the fine ticks counted so far
+ * @last: the fine ticks when last counted
+ *
+ * Add the fine ticks since the last invocation to @total. The fine ticks
+ * wrap around every ~524ms so this has to be invoked more often than
+ * that to measure a longer time.
+ */
+static void
+count_fine_ticks (uint32_t *total, uint16_t *last)
+{
+	const uint16_t now = SCHED_fine_ticks ();
+
+	*total += (uint16_t) (now - *last);
+	*last = now;
+}
+
+/**
+ * display_two_digits:
+ *
+ * @line: the line of the LCD (1 or 2)
+ * @col: the column of the first digit
+ * @bcd: the two BCD digits of the field
+ *
+ * Redraw just the two digits of a field in the required format (see above).
+ */
+static void
+display_two_digits (uint8_t line, uint8_t col, uint8_t bcd)
+{
+	struct lcd_format fmt;
+
+	lcd_format_init (&fmt);
+	lcd_format_bcd (&fmt, bcd);
+	lcd_format_flush (&fmt, line, col);
 }
 
 int
 main (void)
 {
+	struct lcd_pt lcd_pt;
+	_Bool lcd_ready = 0, rtc_ready = 0;
+	uint32_t startup_fine_ticks = 0;
+	uint16_t startup_ms = 0, last_fine_tick = 0;
+	struct RTC_time time = { {0}, {0}, {0} };
+	struct RTC_date date = { {0}, {0}, {0}, {0} };
 
 	/* Debug port */
 	DDRB = 0xFF;
 	PORTB = 0xFF;
 
+	/* The scheduler is used only as the time base of the waits */
+	SCHED_init ();
+	sei ();
+
+	/*
+	 * The startup is timed in the fine ticks which run from SCHED_init
+	 * even with SCHED_XTAL_TICK, where the 1ms ticks only start once
+	 * the square wave is enabled during the bring-up.
+	 */
+	last_fine_tick = SCHED_fine_ticks ();
+
 	/* Initialise the LCD */
 	DDRD = 0xFF;
 	DDRA |= 0x07;
-	initialize_lcd ();
+	lcd_pt_init (&lcd_pt);
 
-	/* Initialise the RTC */
-	if (RTC_init())
+	/*
+	 * Overlap the bring-up of the RTC with the power-on waits of the
+	 * LCD. The time till the first display is then that of the slower
+	 * of the two rather than the sum of both.
+	 */
+	while (!(lcd_ready && rtc_ready))
+	{
+		count_fine_ticks (&startup_fine_ticks, &last_fine_tick);
+
+		if (!lcd_ready)
+		{
+			lcd_ready = (initialize_lcd_async (&lcd_pt) == PT_DONE);
+		}
+
+		if (!rtc_ready)
+		{
+			const int8_t status = rtc_startup (&time, &date);
+
+			if (status == PT_ERROR)
+			{
+				/* Glow all LEDs to indicate ACK failure and exit */
+				PORTB = 0x00;
+				return 1;
+			}
+
+			rtc_ready = (status == PT_DONE);
+		}
+	}
+
+	display_time (time);
+	display_date (date);
+
+	count_fine_ticks (&startup_fine_ticks, &last_fine_tick);
+	startup_ms = startup_fine_ticks / SCHED_FINE_TICKS_PER_MS;
+
+	display_stack_usage ();
+	display_startup_time (startup_ms);
+
+	/* Not needed for the first display; see rtc_startup */
+	if (log_boot ())
+	{
+		/* Glow all LEDs to indicate ACK failure and exit */
+		PORTB = 0x00;
+		return 1;
+	}
+
+#ifdef SCHED_XTAL_TICK
+	/* Time the I2C bit-banging using the CPU clock measured against the crystal */
+	calibrate_delays ();
+	I2C_set_delay (calibrated_delay_us);
+#endif
+
+	if (log_startup_time (startup_ms))
 	{
 		/* Glow all LEDs to indicate ACK failure and exit */
 		PORTB = 0x00;
@@ -123,30 +455,34 @@ main (void)
 
 	while (1)
 	{
-		struct RTC_time time = { {0}, {0}, {0} };
-		struct RTC_date date = { {0}, {0}, {0}, {0} };
+		uint8_t changed = 0;
 
-		if ( RTC_read_time (&time) )
+		if ( RTC_read_changes (&time, &date, &changed) )
 		{
 			/* Glow all LEDs to indicate ACK failure and exit */
 			PORTB = 0x00;
 			return 1;
 		}
-		else
+
+		/* Redraw only the fields that changed (see "Time: HH:MM:SS") */
+		if (changed & RTC_CHANGED_HOURS)
 		{
-			lcd_goto_line_home (1);
-			display_time (time);
+			display_two_digits (1, 0, time.hours.register_val & 0x3F);
 		}
 
-		if ( RTC_read_date (&date) )
+		if (changed & RTC_CHANGED_MINUTES)
 		{
-			/* Glow all LEDs to indicate ACK failure and exit */
-			PORTB = 0x00;
-			return 1;
+			display_two_digits (1, 3, time.minutes.register_val & 0x7F);
 		}
-		else
+
+		if (changed & RTC_CHANGED_SECONDS)
+		{
+			display_two_digits (1, 6, time.seconds.register_val & 0x7F);
+			display_stack_usage ();
+		}
+
+		if (changed & RTC_CHANGED_DATE)
 		{
-			lcd_goto_line_home (2);
 			display_date (date);
 		}
 	}
@@ -1,17 +1,57 @@
 #include "../i2c/i2c.h"
 #include "rtc.h"
+#include "rtc_shadow.h"
+#include <avr/pgmspace.h>
 
 static const uint8_t rtc_slave_addr__write = 0xD0,
                      rtc_slave_addr__read  = 0xD1;
 
-static const uint8_t seconds_register_addr = 0x00;
+static const uint8_t seconds_register_addr = 0x00,
+                     day_register_addr     = 0x03,
+                     control_register_addr = 0x07;
+
+/**
+ * RTC_nvram_range_valid:
+ *
+ * Check whether the range of @len bytes starting at @offset lies
+ * within the NVRAM. The register pointer wraps around to the seconds
+ * register after the last NVRAM byte so a burst must never cross it.
+ */
+static inline _Bool
+RTC_nvram_range_valid (uint8_t offset, uint8_t len)
+{
+	return offset < RTC_NVRAM_SIZE &&
+	       len <= (uint8_t) (RTC_NVRAM_SIZE - offset);
+}
 
-int8_t
-RTC_init (void)
+/**
+ * RTC_register_range_valid:
+ *
+ * Check whether the range of @len bytes starting at @register_addr lies
+ * within the register space. As with the NVRAM, a burst must not wrap
+ * around to the seconds register.
+ */
+static inline _Bool
+RTC_register_range_valid (uint8_t register_addr, uint8_t len)
 {
-	/* Initialize the port pins used by I2C */
-	I2C_init();
+	return register_addr < RTC_REGISTER_SPACE_SIZE &&
+	       len <= (uint8_t) (RTC_REGISTER_SPACE_SIZE - register_addr);
+}
 
+/**
+ * RTC_select_register:
+ *
+ * @register_addr: the address to be loaded into the register pointer
+ *
+ * Start a write transaction and load the register pointer of the RTC
+ * with the given address. The transaction is left open so that the
+ * caller could either continue writing or issue a repeated start to read.
+ *
+ * Returns: 0 if both the bytes were acknowledged else non-zero value.
+ */
+static int8_t
+RTC_select_register (uint8_t register_addr)
+{
 	I2C_start();
 
 	if (I2C_send (rtc_slave_addr__write))
@@ -19,94 +59,138 @@ RTC_init (void)
 		return 1;
 	}
 
-	if (I2C_send (seconds_register_addr))
-	{
-		return 1;
-	}
+	return I2C_send (register_addr);
+}
 
-	if (
-		/*
-		 * Seconds register (Address: 0x00):
-		 *
-		 * Clock Hold (CH) (7): 0 (Starts the clock)
-		 * 10s digit of seconds (6-4): 5
-		 * 1s digit of seconds (3-0): 0
-		 */
-		I2C_send (0x50) ||
-
-		/*
-		 * Minutes register (Address: 0x01):
-		 *
-		 * (7): 0
-		 * 10s digit of minutes (6-4): 5
-		 * 1s digit of minutes (3-0): 9
-		 */
-		I2C_send (0x59) ||
-
-		/*
-		 * Hours register (Address: 0x02)
-		 *
-		 * (7): 0
-		 * 12/24-hour clock (6): 0 (24-hour clock)
-		 * 10s digit of hours (5-4): 2
-		 * 1s digit of hours (3-0): 3
-		 */
-		I2C_send (0x23) ||
-
-		/*
-		 * Day register (Address: 0x03)
-		 *
-		 * (7-3): 0
-		 * Day (2-0): 01 (Wednesday; Week starts from Monday; 1-indexed)
-		 */
-		I2C_send (0x01) ||
-
-		/*
-		 * Date register (Address: 0x04)
-		 *
-		 * (7-6): 0
-		 * 10s digit of date (5-4): 3
-		 * 1s digit of date (3-0): 1
-		 */
-		I2C_send (0x31) ||
-
-		/*
-		 * Month register (Address: 0x05)
-		 *
-		 * (7-5): 0
-		 * 10s digit of month (4): 1
-		 * 1s digit of month (3-0): 2
-		 */
-		I2C_send (0x12) ||
-
-		/*
-		 * Year register (Address: 0x06)
-		 *
-		 * Note: Year is in range 00-99
-		 *
-		 * 10s digit of year (7-4): 1
-		 * 1s digit of year (3-0): 8
-		 */
-		I2C_send (0x18) ||
-
-		/*
-		 * Control register (Address: 0x07):
-		 *
-		 * Output control (OUT) (7): 0 (logic level of output pin is 0)
-		 * (6-5): 0
-		 * Square wave enable (SQWE): 0 (disable square wave output)
-		 * (3-2): 0
-		 * Rate select (1-0) (RS1, RS0): 0 (don't cares)
-		 */
-		I2C_send (0x00)
-	)
+/*
+ * Register image written by RTC_init (see RTC_run_sequence_P for the format).
+ */
+static const uint8_t rtc_init_sequence[] PROGMEM = {
+	/* Start from the seconds register; 8 registers */
+	0x00, 8,
+
+	/*
+	 * Seconds register (Address: 0x00):
+	 *
+	 * Clock Hold (CH) (7): 0 (Starts the clock)
+	 * 10s digit of seconds (6-4): 5
+	 * 1s digit of seconds (3-0): 0
+	 */
+	0x50,
+
+	/*
+	 * Minutes register (Address: 0x01):
+	 *
+	 * (7): 0
+	 * 10s digit of minutes (6-4): 5
+	 * 1s digit of minutes (3-0): 9
+	 */
+	0x59,
+
+	/*
+	 * Hours register (Address: 0x02)
+	 *
+	 * (7): 0
+	 * 12/24-hour clock (6): 0 (24-hour clock)
+	 * 10s digit of hours (5-4): 2
+	 * 1s digit of hours (3-0): 3
+	 */
+	0x23,
+
+	/*
+	 * Day register (Address: 0x03)
+	 *
+	 * (7-3): 0
+	 * Day (2-0): 01 (Wednesday; Week starts from Monday; 1-indexed)
+	 */
+	0x01,
+
+	/*
+	 * Date register (Address: 0x04)
+	 *
+	 * (7-6): 0
+	 * 10s digit of date (5-4): 3
+	 * 1s digit of date (3-0): 1
+	 */
+	0x31,
+
+	/*
+	 * Month register (Address: 0x05)
+	 *
+	 * (7-5): 0
+	 * 10s digit of month (4): 1
+	 * 1s digit of month (3-0): 2
+	 */
+	0x12,
+
+	/*
+	 * Year register (Address: 0x06)
+	 *
+	 * Note: Year is in range 00-99
+	 *
+	 * 10s digit of year (7-4): 1
+	 * 1s digit of year (3-0): 8
+	 */
+	0x18,
+
+	/*
+	 * Control register (Address: 0x07):
+	 *
+	 * Output control (OUT) (7): 0 (logic level of output pin is 0)
+	 * (6-5): 0
+	 * Square wave enable (SQWE): 0 (disable square wave output)
+	 * (3-2): 0
+	 * Rate select (1-0) (RS1, RS0): 0 (don't cares)
+	 */
+	0x00,
+
+	RTC_SEQUENCE_END
+};
+
+int8_t
+RTC_run_sequence_P (const uint8_t *sequence)
+{
+	uint8_t register_addr = pgm_read_byte (sequence++);
+
+	while (register_addr != RTC_SEQUENCE_END)
 	{
-		return 1;
+		uint8_t count = pgm_read_byte (sequence++);
+
+		if (RTC_select_register (register_addr))
+		{
+			return 1;
+		}
+
+		/* Stream the values from the flash using the auto-increment */
+		for (; count > 0; count--, register_addr++)
+		{
+			const uint8_t value = pgm_read_byte (sequence++);
+
+			if (I2C_send (value))
+			{
+				return 1;
+			}
+
+			RTC_shadow_note (register_addr, value);
+		}
+
+		I2C_stop();
+
+		register_addr = pgm_read_byte (sequence++);
 	}
 
 	return 0;
 }
 
+int8_t
+RTC_init (void)
+{
+	/* Initialize the port pins used by I2C */
+	I2C_init();
+
+	return RTC_run_sequence_P (rtc_init_sequence);
+}
+
 int8_t
 RTC_read_time (struct RTC_time *time)
 {
@@ -149,8 +233,6 @@ RTC_read_time (struct RTC_time *time)
 int8_t
 RTC_read_date (struct RTC_date *date)
 {
-	static const uint8_t day_register_addr = 0x03;
-
 	/* Start communication to read the value */
 	I2C_start();
 
@@ -189,3 +271,323 @@ RTC_read_date (struct RTC_date *date)
 	return 0;
 
 }
+
+int8_t
+RTC_read_changes (struct RTC_time *time, struct RTC_date *date,
+                  uint8_t *changed)
+{
+	uint8_t value = 0;
+
+	*changed = 0;
+
+	if (RTC_select_register (seconds_register_addr))
+	{
+		return 1;
+	}
+
+	/* Re-start to read the value from the registers */
+	I2C_start ();
+
+	if (I2C_send (rtc_slave_addr__read))
+	{
+		return 1;
+	}
+
+	value = I2C_receive_unacked ();
+
+	if (value != time->seconds.register_val)
+	{
+		*changed |= RTC_CHANGED_SECONDS;
+	}
+
+	/* The BCD values compare the same as the binary ones */
+	if (value >= time->seconds.register_val)
+	{
+		time->seconds.register_val = value;
+		I2C_acknowledge (I2C_ACK_NACK);
+		I2C_stop();
+		return 0;
+	}
+
+	/* Seconds rolled over; continue with the minutes and hours */
+	time->seconds.register_val = value;
+	I2C_acknowledge (I2C_ACK_ACK);
+
+	value = I2C_receive (I2C_ACK_ACK);
+	if (value != time->minutes.register_val)
+	{
+		*changed |= RTC_CHANGED_MINUTES;
+		time->minutes.register_val = value;
+	}
+
+	value = I2C_receive_unacked ();
+	if (value != time->hours.register_val)
+	{
+		*changed |= RTC_CHANGED_HOURS;
+	}
+
+	if (value >= time->hours.register_val)
+	{
+		time->hours.register_val = value;
+		I2C_acknowledge (I2C_ACK_NACK);
+		I2C_stop();
+		return 0;
+	}
+
+	/* Hours rolled over; the date registers follow the hours register */
+	time->hours.register_val = value;
+	I2C_acknowledge (I2C_ACK_ACK);
+
+	date->dow.register_val = I2C_receive (I2C_ACK_ACK);
+	date->date.register_val = I2C_receive (I2C_ACK_ACK);
+	date->month.register_val = I2C_receive (I2C_ACK_ACK);
+	date->year.register_val = I2C_receive (I2C_ACK_NACK);
+	*changed |= RTC_CHANGED_DATE;
+
+	/* Stop the communication */
+	I2C_stop();
+
+	return 0;
+}
+
+int8_t
+RTC_set_control (uint8_t control)
+{
+	if (RTC_select_register (control_register_addr) || I2C_send (control))
+	{
+		return 1;
+	}
+
+	RTC_shadow_note (control_register_addr, control);
+
+	/* Stop the communication */
+	I2C_stop();
+
+	return 0;
+}
+
+int8_t
+RTC_read_registers (uint8_t register_addr, uint8_t *buf, uint8_t len)
+{
+	if (!RTC_register_range_valid (register_addr, len))
+	{
+		return 1;
+	}
+
+	if (len == 0)
+	{
+		return 0;
+	}
+
+	if (RTC_select_register (register_addr))
+	{
+		return 1;
+	}
+
+	/* Re-start to read the value from the registers */
+	I2C_start ();
+
+	if (I2C_send (rtc_slave_addr__read))
+	{
+		return 1;
+	}
+
+	/* ACK every byte but the last one to continue the burst */
+	for (; len > 1; len--)
+	{
+		*buf++ = I2C_receive (I2C_ACK_ACK);
+	}
+
+	*buf = I2C_receive (I2C_ACK_NACK);
+
+	/* Stop the communication */
+	I2C_stop();
+
+	return 0;
+}
+
+int8_t
+RTC_write_registers (uint8_t register_addr, const uint8_t *buf, uint8_t len)
+{
+	if (!RTC_register_range_valid (register_addr, len))
+	{
+		return 1;
+	}
+
+	if (len == 0)
+	{
+		return 0;
+	}
+
+	if (RTC_select_register (register_addr))
+	{
+		return 1;
+	}
+
+	/* The register pointer auto-increments after every byte written */
+	for (; len > 0; len--, register_addr++, buf++)
+	{
+		if (I2C_send (*buf))
+		{
+			return 1;
+		}
+
+		RTC_shadow_note (register_addr, *buf);
+	}
+
+	/* Stop the communication */
+	I2C_stop();
+
+	return 0;
+}
+
+int8_t
+RTC_nvram_read (uint8_t offset, uint8_t *buf, uint8_t len)
+{
+	if (!RTC_nvram_range_valid (offset, len))
+	{
+		return 1;
+	}
+
+	return RTC_read_registers (RTC_NVRAM_ADDR + offset, buf, len);
+}
+
+int8_t
+RTC_nvram_write (uint8_t offset, const uint8_t *buf, uint8_t len)
+{
+	if (!RTC_nvram_range_valid (offset, len))
+	{
+		return 1;
+	}
+
+	return RTC_write_registers (RTC_NVRAM_ADDR + offset, buf, len);
+}
+
+/**
+ * RTC_transfer_async:
+ *
+ * @pt: state of the operation
+ * @register_addr: address of the first register
+ * @registers: pointers to the values of the successive registers
+ * @count: number of registers
+ * @read: whether to read the registers or to write them
+ *
+ * Common implementation of the asynchronous functions. The pointers
+ * are used so that the fields of the structures need not be in the
+ * order of the registers.
+ */
+static int8_t
+RTC_transfer_async (struct RTC_pt *pt, uint8_t register_addr,
+                    uint8_t *const *registers, uint8_t count, _Bool read)
+{
+	PT_BEGIN (pt->lc);
+
+	I2C_start();
+
+	if (I2C_send (rtc_slave_addr__write))
+	{
+		I2C_stop();
+		PT_EXIT (pt->lc, PT_ERROR);
+	}
+
+	PT_YIELD (pt->lc);
+
+	if (I2C_send (register_addr))
+	{
+		I2C_stop();
+		PT_EXIT (pt->lc, PT_ERROR);
+	}
+
+	if (read)
+	{
+		PT_YIELD (pt->lc);
+
+		/* Re-start to read the value from the registers */
+		I2C_start ();
+
+		if (I2C_send (rtc_slave_addr__read))
+		{
+			I2C_stop();
+			PT_EXIT (pt->lc, PT_ERROR);
+		}
+
+		for (pt->index = 0; pt->index < count; pt->index++)
+		{
+			PT_YIELD (pt->lc);
+
+			/* NACK the last byte to end the burst */
+			*registers[pt->index] = I2C_receive (
+				(pt->index == count - 1) ? I2C_ACK_NACK : I2C_ACK_ACK);
+		}
+	}
+	else
+	{
+		for (pt->index = 0; pt->index < count; pt->index++)
+		{
+			PT_YIELD (pt->lc);
+
+			if (I2C_send (*registers[pt->index]))
+			{
+				I2C_stop();
+				PT_EXIT (pt->lc, PT_ERROR);
+			}
+
+			RTC_shadow_note (register_addr + pt->index, *registers[pt->index]);
+		}
+	}
+
+	/* Stop the communication */
+	I2C_stop();
+
+	PT_END (pt->lc);
+}
+
+int8_t
+RTC_read_time_async (struct RTC_pt *pt, struct RTC_time *time)
+{
+	uint8_t *const registers[] = {
+		&time->seconds.register_val,
+		&time->minutes.register_val,
+		&time->hours.register_val
+	};
+
+	return RTC_transfer_async (pt, seconds_register_addr, registers, 3, 1);
+}
+
+int8_t
+RTC_write_time_async (struct RTC_pt *pt, struct RTC_time *time)
+{
+	uint8_t *const registers[] = {
+		&time->seconds.register_val,
+		&time->minutes.register_val,
+		&time->hours.register_val
+	};
+
+	return RTC_transfer_async (pt, seconds_register_addr, registers, 3, 0);
+}
+
+int8_t
+RTC_read_date_async (struct RTC_pt *pt, struct RTC_date *date)
+{
+	uint8_t *const registers[] = {
+		&date->dow.register_val,
+		&date->date.register_val,
+		&date->month.register_val,
+		&date->year.register_val
+	};
+
+	return RTC_transfer_async (pt, day_register_addr, registers, 4, 1);
+}
+
+int8_t
+RTC_write_date_async (struct RTC_pt *pt, struct RTC_date *date)
+{
+	uint8_t *const registers[] = {
+		&date->dow.register_val,
+		&date->date.register_val,
+		&date->month.register_val,
+		&date->year.register_val
+	};
+
+	return RTC_transfer_async (pt, day_register_addr, registers, 4, 0);
+}
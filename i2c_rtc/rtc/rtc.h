@@ -1,6 +1,8 @@
 #ifndef KS_RTC_I2C
 #define KS_RTC_I2C
 
+#include "../../scheduler/pt/pt.h"
+
 /**
  * Structures used to easily access different bit sequences in the
  * BCD encoded RTC register values.
@@ -144,6 +146,54 @@ struct RTC_date
 	} dow;
 };
 
+/*
+ * The battery backed RAM of the DS1307 (56 bytes) is mapped to the
+ * register addresses 0x08 through 0x3F.
+ */
+#define RTC_NVRAM_ADDR 0x08u
+#define RTC_NVRAM_SIZE 56u
+
+/*
+ * Size of the register space including the NVRAM. The address of the
+ * control register follows that of the timekeeping registers.
+ */
+#define RTC_REGISTER_SPACE_SIZE 64u
+#define RTC_CONTROL_ADDR 0x07u
+
+/*
+ * Bits of the control register (Address: 0x07)
+ */
+#define RTC_CONTROL_OUT (1<<7)
+#define RTC_CONTROL_SQWE (1<<4)
+#define RTC_CONTROL_RATE_1HZ 0x00
+#define RTC_CONTROL_RATE_4096HZ 0x01
+#define RTC_CONTROL_RATE_8192HZ 0x02
+#define RTC_CONTROL_RATE_32768HZ 0x03
+
+/*
+ * Fields reported as changed by RTC_read_changes
+ */
+#define RTC_CHANGED_SECONDS (1<<0)
+#define RTC_CHANGED_MINUTES (1<<1)
+#define RTC_CHANGED_HOURS (1<<2)
+#define RTC_CHANGED_DATE (1<<3)
+
+/* Marks the end of a register sequence (see RTC_run_sequence_P) */
+#define RTC_SEQUENCE_END 0xFFu
+
+/**
+ * RTC_pt:
+ *
+ * State of an asynchronous RTC operation (see RTC_read_time_async).
+ */
+struct RTC_pt
+{
+	uint16_t lc;
+
+	/* Index of the register being transferred */
+	uint8_t index;
+};
+
 /**
  * RTC_init:
  *
@@ -156,6 +206,27 @@ struct RTC_date
 int8_t
 RTC_init (void);
 
+/**
+ * RTC_run_sequence_P:
+ *
+ * @sequence: the register sequence in the flash
+ *
+ * Write blocks of registers whose values are kept in the flash. The
+ * values are streamed to the I2C bus as they are read from the flash
+ * using a single burst per block.
+ *
+ * Format of the sequence:
+ *
+ * 	address of the first register, count of values, values...
+ * 	... (more blocks)
+ * 	RTC_SEQUENCE_END
+ *
+ * Returns: 0 if all the registers were written. Non-zero value in case
+ *          of failure.
+ */
+int8_t
+RTC_run_sequence_P (const uint8_t *sequence);
+
 /**
  * RTC_read_time:
  *
@@ -186,4 +257,146 @@ RTC_read_time (struct RTC_time *time);
 int8_t
 RTC_read_date (struct RTC_date *date);
 
+/**
+ * RTC_read_changes:
+ *
+ * (@time): the time read previously; updated with the current time
+ * (@date): the date read previously; updated with the current date
+ * (@changed): used to return the fields that changed (RTC_CHANGED_*)
+ *
+ * Read only as many registers as required to bring @time and @date up
+ * to date, in a single burst starting at the seconds register:
+ *
+ * 	- Only the seconds register is read if the seconds did not
+ * 	  roll over.
+ *
+ * 	- The minutes and hours are read as well when the seconds
+ * 	  roll over.
+ *
+ * 	- The date registers are read as well when the hours roll over
+ * 	  (at midnight).
+ *
+ * The decision to continue the burst is taken after each register is
+ * received, before acknowledging it.
+ *
+ * Note: @time and @date must initially be read completely (e.g. using
+ *       RTC_read_time and RTC_read_date) and the function has to be
+ *       invoked at least once a minute so that no roll over is missed.
+ *
+ * Returns: 0 if the read was successful. Non-zero value in case
+ *          of failure.
+ */
+int8_t
+RTC_read_changes (struct RTC_time *time, struct RTC_date *date,
+                  uint8_t *changed);
+
+/**
+ * RTC_set_control:
+ *
+ * @control: value of the control register (RTC_CONTROL_*)
+ *
+ * Write the control register which configures the SQW/OUT pin.
+ *
+ * Returns: 0 if the write was successful. Non-zero value in case of failure.
+ */
+int8_t
+RTC_set_control (uint8_t control);
+
+/**
+ * RTC_read_registers:
+ *
+ * @register_addr: address of the first register to read
+ * @buf: buffer used to return the values read
+ * @len: number of registers to read
+ *
+ * Read @len successive registers starting from @register_addr in a single
+ * burst.
+ *
+ * Returns: 0 if the read was successful. Non-zero value in case of failure
+ *          or if the range does not lie within the register space.
+ */
+int8_t
+RTC_read_registers (uint8_t register_addr, uint8_t *buf, uint8_t len);
+
+/**
+ * RTC_write_registers:
+ *
+ * @register_addr: address of the first register to write
+ * @buf: the values to be written
+ * @len: number of registers to write
+ *
+ * Write @len successive registers starting from @register_addr in a single
+ * burst.
+ *
+ * Returns: 0 if the write was successful. Non-zero value in case of failure
+ *          or if the range does not lie within the register space.
+ */
+int8_t
+RTC_write_registers (uint8_t register_addr, const uint8_t *buf, uint8_t len);
+
+/**
+ * RTC_nvram_read:
+ *
+ * @offset: offset of the first byte to read from the start of the NVRAM
+ * @buf: buffer used to return the bytes read
+ * @len: number of bytes to read
+ *
+ * Read @len bytes of the battery backed RAM starting from @offset in a
+ * single burst. The register pointer of the DS1307 is set only once and
+ * its auto-increment is used to read the rest of the bytes.
+ *
+ * Returns: 0 if the read was successful. Non-zero value in case of failure
+ *          or if the requested range does not lie within the NVRAM.
+ */
+int8_t
+RTC_nvram_read (uint8_t offset, uint8_t *buf, uint8_t len);
+
+/**
+ * RTC_nvram_write:
+ *
+ * @offset: offset of the first byte to write from the start of the NVRAM
+ * @buf: the bytes to be written
+ * @len: number of bytes to write
+ *
+ * Write @len bytes to the battery backed RAM starting from @offset in a
+ * single burst using the auto-increment of the register pointer.
+ *
+ * Returns: 0 if the write was successful. Non-zero value in case of failure
+ *          or if the requested range does not lie within the NVRAM.
+ */
+int8_t
+RTC_nvram_write (uint8_t offset, const uint8_t *buf, uint8_t len);
+
+/**
+ * Asynchronous versions of the functions to read and write the time
+ * and date written as stackless coroutines (see scheduler/pt/pt.h).
+ *
+ * Each function has to be invoked repeatedly with the same arguments
+ * till it returns PT_DONE (transfer complete) or PT_ERROR (no ACK). It
+ * returns PT_WAITING after every byte transferred on the I2C bus so
+ * that other work could be done in between. The I2C bus is held
+ * (clock low) between the invocations.
+ *
+ * Only one operation may be in progress at a time as they share the
+ * I2C bus. The state has to be initialised using RTC_pt_init before
+ * starting an operation.
+ */
+static inline void
+RTC_pt_init (struct RTC_pt *pt)
+{
+	PT_INIT (pt->lc);
+}
+
+int8_t
+RTC_read_time_async (struct RTC_pt *pt, struct RTC_time *time);
+
+int8_t
+RTC_read_date_async (struct RTC_pt *pt, struct RTC_date *date);
+
+int8_t
+RTC_write_time_async (struct RTC_pt *pt, struct RTC_time *time);
+
+int8_t
+RTC_write_date_async (struct RTC_pt *pt, struct RTC_date *date);
+
 #endif
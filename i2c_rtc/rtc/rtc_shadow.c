@@ -0,0 +1,178 @@
+#include "rtc_shadow.h"
+
+/* The registers following the timekeeping registers */
+#define RTC_SHADOW_STATIC_ADDR RTC_CONTROL_ADDR
+
+static uint8_t shadow[RTC_REGISTER_SPACE_SIZE];
+
+/* One bit per register of the copy, set when it has to be sent */
+static uint8_t dirty[RTC_REGISTER_SPACE_SIZE / 8];
+
+static inline _Bool
+RTC_shadow_is_dirty (uint8_t register_addr)
+{
+	return dirty[register_addr >> 3] & (1 << (register_addr & 0x07));
+}
+
+static inline void
+RTC_shadow_mark (uint8_t register_addr)
+{
+	dirty[register_addr >> 3] |= (1 << (register_addr & 0x07));
+}
+
+static inline void
+RTC_shadow_clear (uint8_t register_addr)
+{
+	dirty[register_addr >> 3] &= ~(1 << (register_addr & 0x07));
+}
+
+int8_t
+RTC_shadow_load (void)
+{
+	uint8_t i = 0;
+
+	for (i = 0; i < sizeof (dirty); i++)
+	{
+		dirty[i] = 0;
+	}
+
+	return RTC_read_registers (0x00, shadow, RTC_REGISTER_SPACE_SIZE);
+}
+
+int8_t
+RTC_shadow_write (uint8_t register_addr, const uint8_t *buf, uint8_t len)
+{
+	if (register_addr >= RTC_REGISTER_SPACE_SIZE ||
+	    len > (uint8_t) (RTC_REGISTER_SPACE_SIZE - register_addr))
+	{
+		return 1;
+	}
+
+	for (; len > 0; len--, register_addr++, buf++)
+	{
+		/*
+		 * The copy of a timekeeping register goes stale as the
+		 * clock runs so it cannot tell whether the write is
+		 * redundant.
+		 */
+		if (*buf != shadow[register_addr] ||
+		    register_addr < RTC_SHADOW_STATIC_ADDR)
+		{
+			shadow[register_addr] = *buf;
+			RTC_shadow_mark (register_addr);
+		}
+	}
+
+	return 0;
+}
+
+int8_t
+RTC_shadow_read (uint8_t register_addr, uint8_t *buf, uint8_t len)
+{
+	uint8_t first = RTC_REGISTER_SPACE_SIZE, last = 0, i = 0;
+
+	if (register_addr >= RTC_REGISTER_SPACE_SIZE ||
+	    len > (uint8_t) (RTC_REGISTER_SPACE_SIZE - register_addr))
+	{
+		return 1;
+	}
+
+	/* Find the timekeeping registers in the range to be refreshed */
+	for (i = register_addr; i < register_addr + len && i < RTC_SHADOW_STATIC_ADDR; i++)
+	{
+		if (!RTC_shadow_is_dirty (i))
+		{
+			if (first == RTC_REGISTER_SPACE_SIZE)
+			{
+				first = i;
+			}
+
+			last = i;
+		}
+	}
+
+	if (first != RTC_REGISTER_SPACE_SIZE)
+	{
+		uint8_t values[RTC_SHADOW_STATIC_ADDR];
+
+		if (RTC_read_registers (first, values, last - first + 1))
+		{
+			return 1;
+		}
+
+		/* Don't overwrite the pending writes in between */
+		for (i = first; i <= last; i++)
+		{
+			if (!RTC_shadow_is_dirty (i))
+			{
+				shadow[i] = values[i - first];
+			}
+		}
+	}
+
+	for (; len > 0; len--)
+	{
+		*buf++ = shadow[register_addr++];
+	}
+
+	return 0;
+}
+
+int8_t
+RTC_shadow_commit (void)
+{
+	uint8_t start = 0, end = 0, i = 0;
+
+	while (start < RTC_REGISTER_SPACE_SIZE)
+	{
+		/* Skip to the start of the next run of marked registers */
+		if (!RTC_shadow_is_dirty (start))
+		{
+			start++;
+			continue;
+		}
+
+		for (end = start + 1; end < RTC_REGISTER_SPACE_SIZE &&
+		                      RTC_shadow_is_dirty (end); end++);
+
+		if (RTC_write_registers (start, shadow + start, end - start))
+		{
+			return 1;
+		}
+
+		for (i = start; i < end; i++)
+		{
+			RTC_shadow_clear (i);
+		}
+
+		start = end;
+	}
+
+	return 0;
+}
+
+void
+RTC_shadow_note (uint8_t register_addr, uint8_t value)
+{
+	if (register_addr < RTC_REGISTER_SPACE_SIZE)
+	{
+		shadow[register_addr] = value;
+		RTC_shadow_clear (register_addr);
+	}
+}
+
+uint8_t
+RTC_shadow_pending (void)
+{
+	uint8_t count = 0, i = 0;
+
+	for (i = 0; i < RTC_REGISTER_SPACE_SIZE; i++)
+	{
+		if (RTC_shadow_is_dirty (i))
+		{
+			count++;
+		}
+	}
+
+	return count;
+}
@@ -0,0 +1,114 @@
+#ifndef KS_RTC_SHADOW
+#define KS_RTC_SHADOW
+
+/**
+ * A copy of the 64 byte register space of the DS1307 kept in the RAM.
+ *
+ * Writes are made to the copy and a bit is set for every byte that has
+ * to be sent to the RTC. A commit then sends the marked bytes using as
+ * few bursts as possible: successive marked bytes are sent in a single
+ * burst using the auto-increment of the register pointer. Values that
+ * are the same as those held by the RTC are never sent.
+ *
+ * The control register and the NVRAM change only when written, so they
+ * are read from the copy without any I2C communication. The timekeeping
+ * registers (0x00 through 0x06) keep running and are hence always read
+ * from the RTC. For the same reason, writes to them are always sent.
+ *
+ * Writes made by the other functions of rtc.h (RTC_init, RTC_set_control,
+ * RTC_nvram_write and so the NVRAM log, the asynchronous writes) go
+ * directly to the RTC but are noted in the copy (see RTC_shadow_note), so
+ * the copy does not go stale and a pending write of the same register is
+ * dropped rather than committed over the newer value.
+ *
+ * Notes:
+ *
+ * 1. The copy has to be loaded using RTC_shadow_load before it is used.
+ *
+ * 2. The copy must be the only record of the registers: writes to the
+ *    RTC by any other means (raw I2C_send sequences, another master on
+ *    the bus) are not seen and leave it stale till the next load.
+ */
+
+#include <stdint.h>
+#include "rtc.h"
+
+/**
+ * RTC_shadow_load:
+ *
+ * Read the whole register space of the RTC into the copy in a single
+ * burst. Any writes not yet committed are discarded.
+ *
+ * Returns: 0 if the read was successful. Non-zero value in case of failure.
+ */
+int8_t
+RTC_shadow_load (void);
+
+/**
+ * RTC_shadow_write:
+ *
+ * @register_addr: address of the first register to write
+ * @buf: the values to be written
+ * @len: number of registers to write
+ *
+ * Write the values to the copy. Only the registers whose value differs
+ * from the one held by the RTC are marked to be sent on the next commit.
+ *
+ * Returns: 0 on success. Non-zero value if the range does not lie
+ *          within the register space.
+ */
+int8_t
+RTC_shadow_write (uint8_t register_addr, const uint8_t *buf, uint8_t len);
+
+/**
+ * RTC_shadow_read:
+ *
+ * @register_addr: address of the first register to read
+ * @buf: buffer used to return the values
+ * @len: number of registers to read
+ *
+ * Read the values of the registers. The timekeeping registers in the
+ * range that have no pending write are read from the RTC (in a single
+ * burst) and the rest are served from the copy.
+ *
+ * Returns: 0 on success. Non-zero value in case of failure or if the
+ *          range does not lie within the register space.
+ */
+int8_t
+RTC_shadow_read (uint8_t register_addr, uint8_t *buf, uint8_t len);
+
+/**
+ * RTC_shadow_commit:
+ *
+ * Send the values written to the copy since the last commit to the RTC.
+ * Every run of successive marked registers is sent as a single burst.
+ *
+ * Returns: 0 if all the writes were successful. Non-zero value in case of
+ *          failure. The registers that could not be written stay marked
+ *          so that a later commit would retry them.
+ */
+int8_t
+RTC_shadow_commit (void);
+
+/**
+ * RTC_shadow_note:
+ *
+ * @register_addr: address of the register written
+ * @value: the value written
+ *
+ * Record a value written directly to the RTC. The copy takes the value
+ * and a pending write of the register is dropped as it is superseded.
+ * Invoked by the functions of rtc.c for every register they write.
+ */
+void
+RTC_shadow_note (uint8_t register_addr, uint8_t value);
+
+/**
+ * RTC_shadow_pending:
+ *
+ * Returns: the number of registers waiting to be sent on the next commit.
+ */
+uint8_t
+RTC_shadow_pending (void);
+
+#endif
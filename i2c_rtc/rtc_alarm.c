@@ -0,0 +1,177 @@
+/**
+ * Simple program to test the alarms keyed on the time of the RTC.
+ *
+ * The time is read from the RTC once and then advanced by the RAM clock
+ * (see clock/clock.h) which drives the alarms:
+ *
+ * 	- an ALARM_after alarm every 5 seconds (re-armed by its callback)
+ * 	- an ALARM_at alarm at the start of every minute (re-armed by its
+ * 	  callback for the next minute)
+ *
+ * LCD:
+ *
+ * 		HH:MM:SS
+ * 		5s:NNNNN m:NNNNN
+ *
+ * where the numbers are the counts of the alarms fired.
+ *
+ * PB2 (INT2) - SQW/OUT of the DS1307
+ * PORTB - output (LEDs on 4-7, active low):
+ *
+ * 	Pin 4: toggles on every 5 second alarm
+ * 	Pin 5: toggles on every minute alarm
+ * 	All: glow in case of I2C failure
+ */
+
+#include <stddef.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+#include "rtc/rtc.h"
+#include "clock/clock.h"
+#include "alarm/alarm.h"
+#include "../lcd_display/lcd/lcd.h"
+#include "../lcd_display/lcd/lcd_format.h"
+
+#define SHORT_PERIOD_S 5u
+
+static uint16_t short_count = 0;
+static uint16_t minute_count = 0;
+
+static void every_minute (void);
+
+static uint8_t
+bcd_to_bin (uint8_t bcd)
+{
+	return (bcd >> 4) * 10 + (bcd & 0x0F);
+}
+
+static uint8_t
+bin_to_bcd (uint8_t bin)
+{
+	return ((bin / 10) << 4) | (bin % 10);
+}
+
+/**
+ * arm_next_minute:
+ *
+ * Add an alarm at the start of the minute following the current time.
+ */
+static void
+arm_next_minute (void)
+{
+	struct RTC_time when;
+	uint8_t minutes = 0, hours = 0;
+
+	CLOCK_snapshot (&when, NULL);
+
+	minutes = bcd_to_bin (when.minutes.register_val) + 1;
+	hours = bcd_to_bin (when.hours.register_val & 0x3F);
+
+	if (minutes == 60)
+	{
+		minutes = 0;
+		hours = (hours + 1) % 24;
+	}
+
+	when.seconds.register_val = 0x00;
+	when.minutes.register_val = bin_to_bcd (minutes);
+	when.hours.register_val = bin_to_bcd (hours);
+
+	ALARM_at (&when, every_minute, 0);
+}
+
+static void
+every_short_period (void)
+{
+	PORTB ^= (1<<PB4);
+	short_count++;
+
+	ALARM_after (SHORT_PERIOD_S, every_short_period);
+}
+
+static void
+every_minute (void)
+{
+	PORTB ^= (1<<PB5);
+	minute_count++;
+
+	arm_next_minute ();
+}
+
+/**
+ * display:
+ *
+ * Display the time and the counts of the alarms fired.
+ */
+static void
+display (const struct RTC_time *time)
+{
+	struct lcd_format fmt;
+
+	lcd_format_init (&fmt);
+	lcd_format_bcd (&fmt, time->hours.register_val & 0x3F);
+	lcd_format_char (&fmt, ':');
+	lcd_format_bcd (&fmt, time->minutes.register_val);
+	lcd_format_char (&fmt, ':');
+	lcd_format_bcd (&fmt, time->seconds.register_val & 0x7F);
+	lcd_format_flush (&fmt, 1, 0);
+
+	lcd_format_init (&fmt);
+	lcd_format_P (&fmt, PSTR ("5s:"));
+	lcd_format_uint (&fmt, short_count, 5, '0');
+	lcd_format_P (&fmt, PSTR (" m:"));
+	lcd_format_uint (&fmt, minute_count, 5, '0');
+	lcd_format_flush (&fmt, 2, 0);
+}
+
+int
+main (void)
+{
+	struct RTC_time time = { {0}, {0}, {0} };
+	struct RTC_date date = { {0}, {0}, {0}, {0} };
+	uint8_t seen = 0;
+
+	/* Debug LEDs; PB2 is left to CLOCK_init */
+	DDRB = 0xF0;
+	PORTB = 0xF0;
+
+	/* Initialise the LCD */
+	DDRD = 0xFF;
+	DDRA |= 0x07;
+	initialize_lcd ();
+
+	if (RTC_init () || RTC_read_time (&time) || RTC_read_date (&date) ||
+	    CLOCK_init (&time, &date))
+	{
+		/* Glow all LEDs to indicate ACK failure and exit */
+		PORTB = 0x00;
+		return 1;
+	}
+
+	seen = CLOCK_seconds ();
+
+	ALARM_init (&time);
+	ALARM_after (SHORT_PERIOD_S, every_short_period);
+	arm_next_minute ();
+
+	sei ();
+
+	display (&time);
+
+	while (1)
+	{
+		/* Drive the alarms on every edge of SQW */
+		if (CLOCK_seconds () != seen)
+		{
+			seen = CLOCK_seconds ();
+
+			CLOCK_snapshot (&time, NULL);
+			ALARM_tick (&time);
+			display (&time);
+		}
+	}
+
+	return 0;
+}
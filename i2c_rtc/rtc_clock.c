@@ -0,0 +1,99 @@
+/**
+ * Simple program to test the RAM clock advanced by the square wave of
+ * the RTC.
+ *
+ * The time and date are read from the RTC once; afterwards they are
+ * shown from the RAM clock without any I2C communication:
+ *
+ * 		HH:MM:SS   NNN
+ * 		DD/MM/YY
+ *
+ * where NNN is the number of edges of SQW seen (wraps at 255).
+ *
+ * PB2 (INT2) - SQW/OUT of the DS1307
+ * PORTB - output (LEDs on 4-7, active low): all glow in case of I2C
+ *         failure.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#include "rtc/rtc.h"
+#include "clock/clock.h"
+#include "../lcd_display/lcd/lcd.h"
+#include "../lcd_display/lcd/lcd_format.h"
+
+/**
+ * display_clock:
+ *
+ * Display a snapshot of the RAM clock.
+ */
+static void
+display_clock (void)
+{
+	struct RTC_time time;
+	struct RTC_date date;
+	struct lcd_format fmt;
+
+	CLOCK_snapshot (&time, &date);
+
+	lcd_format_init (&fmt);
+	lcd_format_bcd (&fmt, time.hours.register_val & 0x3F);
+	lcd_format_char (&fmt, ':');
+	lcd_format_bcd (&fmt, time.minutes.register_val);
+	lcd_format_char (&fmt, ':');
+	lcd_format_bcd (&fmt, time.seconds.register_val & 0x7F);
+	lcd_format_char (&fmt, ' ');
+	lcd_format_uint (&fmt, CLOCK_seconds (), 5, ' ');
+	lcd_format_flush (&fmt, 1, 0);
+
+	lcd_format_init (&fmt);
+	lcd_format_bcd (&fmt, date.date.register_val);
+	lcd_format_char (&fmt, '/');
+	lcd_format_bcd (&fmt, date.month.register_val);
+	lcd_format_char (&fmt, '/');
+	lcd_format_bcd (&fmt, date.year.register_val);
+	lcd_format_flush (&fmt, 2, 0);
+}
+
+int
+main (void)
+{
+	struct RTC_time time = { {0}, {0}, {0} };
+	struct RTC_date date = { {0}, {0}, {0}, {0} };
+	uint8_t shown = 0;
+
+	/* Debug LEDs; PB2 is left to CLOCK_init */
+	DDRB = 0xF0;
+	PORTB = 0xF0;
+
+	/* Initialise the LCD */
+	DDRD = 0xFF;
+	DDRA |= 0x07;
+	initialize_lcd ();
+
+	if (RTC_init () || RTC_read_time (&time) || RTC_read_date (&date) ||
+	    CLOCK_init (&time, &date))
+	{
+		/* Glow all LEDs to indicate ACK failure and exit */
+		PORTB = 0x00;
+		return 1;
+	}
+
+	sei ();
+
+	shown = CLOCK_seconds ();
+	display_clock ();
+
+	while (1)
+	{
+		/* Redraw on every edge of SQW */
+		if (CLOCK_seconds () != shown)
+		{
+			shown = CLOCK_seconds ();
+			display_clock ();
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,327 @@
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include "capture.h"
+#include "../../scheduler/ring/ring.h"
+#include "../../scheduler/power/power.h"
+
+/* Room for 21 events of 6 bytes */
+RING_DEFINE (events, 128);
+
+/* Overflows of Timer1; the high 16 bits of the time */
+static volatile uint16_t overflows = 0;
+
+static volatile uint16_t dropped = 0;
+
+/* Whether both the edges are to be timestamped, by source */
+static uint8_t both_edges = 0;
+
+static volatile uint16_t latency_min = UINT16_MAX;
+static volatile uint16_t latency_max = 0;
+
+/**
+ * CAPTURE_extend:
+ *
+ * @count: a value of Timer1 read with the interrupts disabled
+ *
+ * Returns: the 32-bit time corresponding to @count.
+ */
+static inline uint32_t
+CAPTURE_extend (uint16_t count)
+{
+	uint16_t high = overflows;
+
+	/*
+	 * The timer has overflowed but the interrupt is yet to be serviced.
+	 * A small count was read after the overflow; a large one just
+	 * before it.
+	 */
+	if ((TIFR & (1<<TOV1)) && count < 0x8000u)
+	{
+		high++;
+	}
+
+	return ((uint32_t) high << 16) | count;
+}
+
+/**
+ * CAPTURE_record:
+ *
+ * Queue an event. Invoked only from the interrupts which do not nest, so
+ * there is a single producer for the queue.
+ */
+static inline void
+CAPTURE_record (uint16_t count, uint8_t source, uint8_t rising)
+{
+	const struct CAPTURE_event event = {
+		CAPTURE_extend (count), source, rising
+	};
+
+	if (RING_push_span (&events, (const uint8_t *) &event, sizeof (event)))
+	{
+		dropped++;
+		return;
+	}
+
+	POWER_notify ();
+}
+
+ISR (TIMER1_OVF_vect)
+{
+	overflows++;
+}
+
+ISR (TIMER1_CAPT_vect)
+{
+	const uint16_t entry = TCNT1;
+	const uint16_t capture = ICR1;
+	const uint8_t rising = (TCCR1B & (1<<ICES1)) ? 1 : 0;
+	const uint16_t latency = entry - capture;
+
+	if (latency < latency_min)
+	{
+		latency_min = latency;
+	}
+
+	if (latency > latency_max)
+	{
+		latency_max = latency;
+	}
+
+	/* Wait for the opposite edge next */
+	if (both_edges & (1<<CAPTURE_ICP1))
+	{
+		TCCR1B ^= (1<<ICES1);
+
+		/* Changing the edge could set the flag (see the data sheet) */
+		TIFR = (1<<ICF1);
+	}
+
+	CAPTURE_record (capture, CAPTURE_ICP1, rising);
+}
+
+/*
+ * The edge of INT0/INT1 is known from ISCn0 when a single edge is sensed
+ * (ISCn1 set). Only in the any change mode has the level of the pin to be
+ * read, which a pulse shorter than the latency of the ISR could defeat.
+ */
+ISR (INT0_vect)
+{
+	const uint16_t entry = TCNT1;
+	const uint8_t rising = (both_edges & (1<<CAPTURE_INT0)) ?
+	                       ((PIND >> PD2) & 1) :
+	                       ((MCUCR & (1<<ISC00)) ? 1 : 0);
+
+	CAPTURE_record (entry, CAPTURE_INT0, rising);
+}
+
+ISR (INT1_vect)
+{
+	const uint16_t entry = TCNT1;
+	const uint8_t rising = (both_edges & (1<<CAPTURE_INT1)) ?
+	                       ((PIND >> PD3) & 1) :
+	                       ((MCUCR & (1<<ISC10)) ? 1 : 0);
+
+	CAPTURE_record (entry, CAPTURE_INT1, rising);
+}
+
+ISR (INT2_vect)
+{
+	const uint16_t entry = TCNT1;
+	const uint8_t rising = (MCUCSR & (1<<ISC2)) ? 1 : 0;
+
+	/* INT2 senses only one of the edges at a time */
+	if (both_edges & (1<<CAPTURE_INT2))
+	{
+		MCUCSR ^= (1<<ISC2);
+		GIFR = (1<<INTF2);
+	}
+
+	CAPTURE_record (entry, CAPTURE_INT2, rising);
+}
+
+void
+CAPTURE_init (void)
+{
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+#ifndef SCHED_XTAL_TICK
+		/* Normal mode, no prescaling */
+		TCCR1A = 0;
+		TCCR1B = (1<<CS10);
+#endif
+
+		overflows = 0;
+		dropped = 0;
+		latency_min = UINT16_MAX;
+		latency_max = 0;
+		events.head = events.tail = 0;
+
+		TIFR = (1<<TOV1);
+		TIMSK |= (1<<TOIE1);
+	}
+}
+
+void
+CAPTURE_enable (uint8_t source, uint8_t edge)
+{
+	/* Edge select bits of INT0; shifted by 2 for INT1 */
+	const uint8_t isc = (edge == CAPTURE_EDGE_BOTH) ? (1<<ISC00) :
+	                    (edge == CAPTURE_EDGE_RISING) ? ((1<<ISC01) | (1<<ISC00)) :
+	                    (1<<ISC01);
+
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		if (edge == CAPTURE_EDGE_BOTH)
+		{
+			both_edges |= (1<<source);
+		}
+		else
+		{
+			both_edges &= ~(1<<source);
+		}
+
+		switch (source)
+		{
+			case CAPTURE_ICP1:
+				/* Start with the rising edge when both are required */
+				TCCR1B = (TCCR1B & ~(1<<ICES1)) | (1<<ICNC1) |
+				         ((edge != CAPTURE_EDGE_FALLING) ? (1<<ICES1) : 0);
+				TIFR = (1<<ICF1);
+				TIMSK |= (1<<TICIE1);
+				break;
+
+			case CAPTURE_INT0:
+				MCUCR = (MCUCR & ~((1<<ISC01) | (1<<ISC00))) | isc;
+				GIFR = (1<<INTF0);
+				GICR |= (1<<INT0);
+				break;
+
+			case CAPTURE_INT1:
+				MCUCR = (MCUCR & ~((1<<ISC11) | (1<<ISC10))) | (isc << 2);
+				GIFR = (1<<INTF1);
+				GICR |= (1<<INT1);
+				break;
+
+			case CAPTURE_INT2:
+				/* The interrupt must be disabled while changing the edge */
+				GICR &= ~(1<<INT2);
+				MCUCSR = (MCUCSR & ~(1<<ISC2)) |
+				         ((edge != CAPTURE_EDGE_FALLING) ? (1<<ISC2) : 0);
+				GIFR = (1<<INTF2);
+				GICR |= (1<<INT2);
+				break;
+		}
+	}
+}
+
+void
+CAPTURE_disable (uint8_t source)
+{
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		switch (source)
+		{
+			case CAPTURE_ICP1:
+				TIMSK &= ~(1<<TICIE1);
+				break;
+
+			case CAPTURE_INT0:
+				GICR &= ~(1<<INT0);
+				break;
+
+			case CAPTURE_INT1:
+				GICR &= ~(1<<INT1);
+				break;
+
+			case CAPTURE_INT2:
+				GICR &= ~(1<<INT2);
+				break;
+		}
+	}
+}
+
+int8_t
+CAPTURE_get (struct CAPTURE_event *event)
+{
+	/* Events are pushed whole so a part of one is never seen */
+	if (RING_count (&events) < sizeof (*event))
+	{
+		return 1;
+	}
+
+	RING_pop_span (&events, (uint8_t *) event, sizeof (*event));
+
+	return 0;
+}
+
+uint32_t
+CAPTURE_now (void)
+{
+	uint32_t now = 0;
+
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		now = CAPTURE_extend (TCNT1);
+	}
+
+	return now;
+}
+
+uint16_t
+CAPTURE_dropped (void)
+{
+	uint16_t count = 0;
+
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		count = dropped;
+	}
+
+	return count;
+}
+
+void
+CAPTURE_get_latency (uint16_t *min, uint16_t *max)
+{
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		*min = latency_min;
+		*max = latency_max;
+	}
+}
+
+void
+CAPTURE_period_init (struct CAPTURE_period *period)
+{
+	period->min = UINT32_MAX;
+	period->max = 0;
+	period->total = 0;
+	period->count = 0;
+	period->started = 0;
+}
+
+void
+CAPTURE_period_add (struct CAPTURE_period *period, uint32_t time)
+{
+	/* The first event only marks the start of the first interval */
+	if (period->started)
+	{
+		const uint32_t interval = time - period->last;
+
+		if (interval < period->min)
+		{
+			period->min = interval;
+		}
+
+		if (interval > period->max)
+		{
+			period->max = interval;
+		}
+
+		period->total += interval;
+		period->count++;
+	}
+
+	period->last = time;
+	period->started = 1;
+}
@@ -0,0 +1,184 @@
+#ifndef KS_CAPTURE_ATMEGA32
+#define KS_CAPTURE_ATMEGA32
+
+/**
+ * Timestamping of the edges on the input capture pin and the external
+ * interrupt pins of the ATMEGA32 running at 1MHz.
+ *
+ * Timer1 runs freely from the CPU clock (1us per count) and its 16-bit
+ * count is extended to 32 bits by counting its overflows (the time wraps
+ * around after ~71 minutes at 1us per count). Every edge is queued as an event holding
+ * its time, source and direction till the main line gets it. Nothing
+ * is polled.
+ *
+ * Sources:
+ *
+ * 	CAPTURE_ICP1 - the edge is latched by the hardware (ICR1) so its
+ * 	               time is exact to the count irrespective of when the
+ * 	               interrupt is serviced. The noise canceler is enabled
+ * 	               (the edge is delayed by 4 cycles).
+ *
+ * 	CAPTURE_INT0, CAPTURE_INT1, CAPTURE_INT2 - the count is read on
+ * 	               entering the interrupt so the time includes the
+ * 	               interrupt response.
+ *
+ * 	The difference between the two is measured for every ICP1 edge
+ * 	(see CAPTURE_get_latency) which gives the interrupt response time.
+ *
+ * Pins:
+ *
+ * 	PD6 (ICP1), PD2 (INT0), PD3 (INT1), PB2 (INT2) - the pins are not
+ * 	configured by this module.
+ *
+ * Notes:
+ *
+ * 1. Timer1 must not be used by anything else except the profiler
+ *    (scheduler/prof/prof.h) which needs the same configuration. With
+ *    SCHED_XTAL_TICK the free running Timer1 of the scheduler is used as
+ *    is (8us per count).
+ *
+ * 2. PD2, PD3 and PD6 are a part of the data bus of the LCD in the other
+ *    programs and INT2 is used by the RAM clock (i2c_rtc/clock); those
+ *    sources cannot be used together with them.
+ *
+ * 3. Events are dropped (and counted) when the queue is full.
+ *
+ * 4. Global interrupts have to be enabled.
+ *
+ * 5. Every queued event is notified to the sleep manager (see
+ *    POWER_notify in scheduler/power/power.h), so power.c and sched.c
+ *    have to be linked as well.
+ */
+
+#include <stdint.h>
+#include <avr/io.h>
+
+/* Sources of the events */
+#define CAPTURE_ICP1 0u
+#define CAPTURE_INT0 1u
+#define CAPTURE_INT1 2u
+#define CAPTURE_INT2 3u
+
+/* Edges to be timestamped */
+#define CAPTURE_EDGE_FALLING 0u
+#define CAPTURE_EDGE_RISING 1u
+#define CAPTURE_EDGE_BOTH 2u
+
+#ifdef SCHED_XTAL_TICK
+#define CAPTURE_US_PER_COUNT 8u
+#else
+#define CAPTURE_US_PER_COUNT 1u
+#endif
+
+/**
+ * CAPTURE_event:
+ *
+ * @time: time of the edge in counts of Timer1
+ * @source: the source of the edge (CAPTURE_ICP1, CAPTURE_INT*)
+ * @rising: 1 for a rising edge, 0 for a falling edge
+ */
+struct CAPTURE_event
+{
+	uint32_t time;
+	uint8_t source;
+	uint8_t rising;
+};
+
+/**
+ * CAPTURE_period:
+ *
+ * Statistics of the intervals between successive events of a source
+ * (in counts of Timer1). The jitter is the difference of @max and @min.
+ */
+struct CAPTURE_period
+{
+	uint32_t last;
+	uint32_t min;
+	uint32_t max;
+	uint32_t total;
+	uint16_t count;
+	uint8_t started;
+};
+
+/**
+ * CAPTURE_init:
+ *
+ * Start Timer1 and clear the queue. No source is enabled.
+ */
+void
+CAPTURE_init (void);
+
+/**
+ * CAPTURE_enable:
+ *
+ * @source: the source (CAPTURE_ICP1, CAPTURE_INT*)
+ * @edge: the edges to be timestamped (CAPTURE_EDGE_*)
+ */
+void
+CAPTURE_enable (uint8_t source, uint8_t edge);
+
+/**
+ * CAPTURE_disable:
+ *
+ * @source: the source (CAPTURE_ICP1, CAPTURE_INT*)
+ */
+void
+CAPTURE_disable (uint8_t source);
+
+/**
+ * CAPTURE_get:
+ *
+ * @event: used to return the oldest event
+ *
+ * Returns: 0 if an event was returned. Non-zero value if there is none.
+ */
+int8_t
+CAPTURE_get (struct CAPTURE_event *event);
+
+/**
+ * CAPTURE_now:
+ *
+ * Returns: the current time in counts of Timer1; the difference from
+ *          the time of an event is the latency of its handling.
+ */
+uint32_t
+CAPTURE_now (void);
+
+/**
+ * CAPTURE_dropped:
+ *
+ * Returns: the number of events dropped as the queue was full.
+ */
+uint16_t
+CAPTURE_dropped (void);
+
+/**
+ * CAPTURE_get_latency:
+ *
+ * @min: used to return the least interrupt response time
+ * @max: used to return the greatest interrupt response time
+ *
+ * The response time is the counts from the edge on ICP1 till its
+ * interrupt read Timer1. Both are 0xFFFF/0 if no edge has been captured.
+ */
+void
+CAPTURE_get_latency (uint16_t *min, uint16_t *max);
+
+/**
+ * CAPTURE_period_init:
+ *
+ * @period: the statistics to be cleared
+ */
+void
+CAPTURE_period_init (struct CAPTURE_period *period);
+
+/**
+ * CAPTURE_period_add:
+ *
+ * @period: the statistics
+ * @time: time of the next event of the source
+ */
+void
+CAPTURE_period_add (struct CAPTURE_period *period, uint32_t time);
+
+#endif
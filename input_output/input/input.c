@@ -0,0 +1,99 @@
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include "input.h"
+#include "../../scheduler/power/power.h"
+
+/*
+ * Timer2 configuration for sampling every ~5ms from the 1MHz clock:
+ *
+ * 	1MHz / 256 (prescaler) = 3906Hz => 20 counts = 5.12ms
+ */
+#define SAMPLE_PRESCALER_BITS ((1<<CS22) | (1<<CS21))
+#define SAMPLE_COUNTS 20u
+
+static uint8_t active_low_pins = 0;
+
+/* Debounced state and the vertical counters */
+static volatile uint8_t state = 0;
+static uint8_t count_0 = 0, count_1 = 0;
+
+/* Latched events */
+static volatile uint8_t pressed = 0, released = 0;
+
+ISR (TIMER2_COMP_vect)
+{
+	/* Pins whose sample differs from the debounced state */
+	const uint8_t changed = (INPUT_PIN ^ active_low_pins) ^ state;
+	uint8_t toggle = 0;
+
+	/*
+	 * Count the successive samples of the changed pins and reset the
+	 * counters of the rest. The counters of all the pins are
+	 * incremented (modulo 4) with two logic operations.
+	 */
+	count_1 = (count_1 ^ count_0) & changed;
+	count_0 = ~count_0 & changed;
+
+	/* Pins whose counter rolled over after 4 samples */
+	toggle = changed & ~(count_0 | count_1);
+
+	state ^= toggle;
+	pressed |= toggle & state;
+	released |= toggle & ~state;
+
+	/* A latched event has to be read by the main line */
+	if (toggle)
+	{
+		POWER_notify ();
+	}
+}
+
+void
+INPUT_init (uint8_t active_low)
+{
+	active_low_pins = active_low;
+	state = 0;
+	count_0 = count_1 = 0;
+	pressed = released = 0;
+
+	/* CTC mode, clear the counter on compare match */
+	TCCR2 = (1<<WGM21) | SAMPLE_PRESCALER_BITS;
+	OCR2 = SAMPLE_COUNTS - 1;
+	TCNT2 = 0;
+	TIMSK |= (1<<OCIE2);
+}
+
+uint8_t
+INPUT_state (void)
+{
+	return state;
+}
+
+uint8_t
+INPUT_get_pressed (uint8_t mask)
+{
+	uint8_t events = 0;
+
+	/* The events could be latched by the ISR in between the read and clear */
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		events = pressed & mask;
+		pressed &= ~mask;
+	}
+
+	return events;
+}
+
+uint8_t
+INPUT_get_released (uint8_t mask)
+{
+	uint8_t events = 0;
+
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		events = released & mask;
+		released &= ~mask;
+	}
+
+	return events;
+}
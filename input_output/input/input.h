@@ -0,0 +1,81 @@
+#ifndef KS_INPUT_ATMEGA32
+#define KS_INPUT_ATMEGA32
+
+/**
+ * Debouncing of the switches connected to a port of the ATMEGA32
+ * running at 1MHz.
+ *
+ * The whole port is sampled every ~5ms from the Timer2 compare match
+ * interrupt. All the eight pins are debounced at once using vertical
+ * counters: bit n of the two counter bytes form a 2-bit counter for pin n.
+ * A pin has to read the same for 4 successive samples (~20ms) before its
+ * debounced state changes. Each sample takes the same few logic
+ * instructions regardless of the number of switches.
+ *
+ * The changes of the debounced state are latched as pressed (became
+ * active) and released (became inactive) events till they are read.
+ *
+ * Pins:
+ *
+ * 	INPUT_PIN (all 8 pins) - switches; the pins are not configured
+ * 	                         by this module
+ *
+ * Notes:
+ *
+ * 1. Timer2 must not be used by anything else.
+ *
+ * 2. Global interrupts have to be enabled for the sampling to progress.
+ *
+ * 3. Every latched event is notified to the sleep manager (see
+ *    POWER_notify in scheduler/power/power.h), so power.c and sched.c
+ *    have to be linked as well.
+ */
+
+#include <stdint.h>
+#include <avr/io.h>
+
+#define INPUT_PIN PINA
+
+/**
+ * INPUT_init:
+ *
+ * @active_low: mask of the pins that are active (pressed) when low
+ *
+ * Start sampling the port. The pins are initially considered inactive.
+ */
+void
+INPUT_init (uint8_t active_low);
+
+/**
+ * INPUT_state:
+ *
+ * Returns: the debounced state of the pins; 1 for active pins.
+ */
+uint8_t
+INPUT_state (void);
+
+/**
+ * INPUT_get_pressed:
+ *
+ * @mask: the pins of interest
+ *
+ * Read and clear the latched press events of the given pins.
+ *
+ * Returns: mask of the pins that were pressed since the last call.
+ */
+uint8_t
+INPUT_get_pressed (uint8_t mask);
+
+/**
+ * INPUT_get_released:
+ *
+ * @mask: the pins of interest
+ *
+ * Read and clear the latched release events of the given pins.
+ *
+ * Returns: mask of the pins that were released since the last call.
+ */
+uint8_t
+INPUT_get_released (uint8_t mask);
+
+#endif
@@ -0,0 +1,67 @@
+/**
+ * Simple program to test the timestamping of the edges.
+ *
+ * PD6 (ICP1) - square wave to be measured (e.g. the 1Hz SQW/OUT of the
+ *              DS1307 with a pull-up)
+ * PD2 (INT0) - switch (active low, internal pull-up enabled)
+ * PORTB - output (LEDs, active low):
+ *
+ * 	Normally shows the jitter of the period of the square wave in us
+ * 	(the difference between the longest and the shortest period).
+ *
+ * 	On every press of the switch shows the time in us from the edge
+ * 	till the main line handled it.
+ *
+ * Both the values saturate at 255.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "capture/capture.h"
+
+static uint8_t
+saturate (uint32_t counts)
+{
+	const uint32_t us = counts * CAPTURE_US_PER_COUNT;
+
+	return (us > 0xFF) ? 0xFF : us;
+}
+
+int main (void)
+{
+	struct CAPTURE_period sqw;
+	struct CAPTURE_event event;
+
+	DDRD = 0x00;
+	PORTD = (1<<PD6) | (1<<PD2);
+	DDRB = 0xFF;
+	PORTB = 0xFF;
+
+	CAPTURE_period_init (&sqw);
+	CAPTURE_init ();
+	CAPTURE_enable (CAPTURE_ICP1, CAPTURE_EDGE_FALLING);
+	CAPTURE_enable (CAPTURE_INT0, CAPTURE_EDGE_FALLING);
+	sei ();
+
+	while (1)
+	{
+		if (CAPTURE_get (&event))
+		{
+			continue;
+		}
+
+		if (event.source == CAPTURE_ICP1)
+		{
+			CAPTURE_period_add (&sqw, event.time);
+
+			if (sqw.count > 0)
+			{
+				PORTB = ~saturate (sqw.max - sqw.min);
+			}
+		}
+		else
+		{
+			PORTB = ~saturate (CAPTURE_now () - event.time);
+		}
+	}
+}
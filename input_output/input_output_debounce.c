@@ -0,0 +1,28 @@
+/**
+ * Simple program to test the debouncing of the switches.
+ *
+ * Every press of a switch toggles the corresponding LED.
+ *
+ * PORTA - input from switches (active low, internal pull-ups enabled)
+ * PORTB - output
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "input/input.h"
+
+int main (void)
+{
+	DDRA = 0x00;
+	PORTA = 0xFF;
+	DDRB = 0xFF;
+	PORTB = 0xFF;
+
+	INPUT_init (0xFF);
+	sei ();
+
+	while (1)
+	{
+		PORTB ^= INPUT_get_pressed (0xFF);
+	}
+}
@@ -10,7 +10,7 @@
  * 	DB: Data Bus of LCD
  */
 
-void lcd_command (uint8_t cmd)
+void lcd_send_command (uint8_t cmd)
 {
 	/*
 	 * EN (0): 1
@@ -24,12 +24,25 @@ void lcd_command (uint8_t cmd)
 
 	/* clear all pins */
 	PORTA = 0x00;
+}
+
+void lcd_command (uint8_t cmd)
+{
+	lcd_send_command (cmd);
 
 	/* wait for some time */
 	_delay_ms(2);
 }
 
-void lcd_data (uint8_t data)
+void lcd_quick_command (uint8_t cmd)
+{
+	lcd_send_command (cmd);
+
+	/* Long enough for all but the clear display and return home commands */
+	_delay_us (LCD_WAIT_UNIT_US);
+}
+
+void lcd_send_data (uint8_t data)
 {
 	/*
 	 * EN (0): 1
@@ -43,6 +56,11 @@ void lcd_data (uint8_t data)
 
 	/* clear all pins */
 	PORTA = 0x00;
+}
+
+void lcd_data (uint8_t data)
+{
+	lcd_send_data (data);
 
 	/* wait for some time */
 	_delay_us (100);
@@ -67,26 +85,24 @@ void lcd_goto_line_home (uint8_t line)
 		lcd_command (0xC0);
 	}
 }
-void initialize_lcd(void)
-{
-	/* Initialization sequence */
+/*
+ * Initialization sequence as per the data sheet of the LCD.
+ *
+ * The wait is done before the command so that the initial power-on
+ * wait is a part of the sequence.
+ */
+const struct lcd_step lcd_init_sequence[LCD_INIT_SEQUENCE_LENGTH] PROGMEM = {
 	/* 1. Initial wait for more than 15ms */
-	_delay_ms (20u);
-
-	/* 2. Write initialization specific data to pins (as per data sheet of LCD) */
-	lcd_command (0x30);
+	/* 2. Write initialization specific data to pins */
+	{ 200u, 0x30 },
 
 	/* 3. Wait for more than 4.1ms */
-	_delay_ms (5u);
-
-	/* 4. Write initialization specific data to pins (as per data sheet of LCD) */
-	lcd_command (0x30);
+	/* 4. Write initialization specific data to pins */
+	{ 50u, 0x30 },
 
 	/* 5. Wait for more than 100us (micro seconds) */
-	_delay_us (150u);
-
-	/* 6. Write initialization specific data to pins (as per data sheet of LCD) */
-	lcd_command (0x30);
+	/* 6. Write initialization specific data to pins */
+	{ 2u, 0x30 },
 
 	/* 7. Initialization instructions */
 	/*
@@ -101,20 +117,20 @@ void initialize_lcd(void)
 	 * DB1: DON'T CARE
 	 * DB0: DON'T CARE
 	 */
-	lcd_command (0x3C);
+	{ 1u, 0x3C },
 
 	/**
 	 * Display OFF
 	 */
-	lcd_command (0x08);
+	{ 1u, 0x08 },
 
 	/**
 	 * Clear display
 	 */
-	lcd_command (0x01);
+	{ 1u, 0x01 },
 
 	/**
-	 * Entry mode set:
+	 * Entry mode set (after the 1.52ms taken by clear display):
 	 *
 	 * DB7: 0
 	 * DB6: 0
@@ -125,7 +141,7 @@ void initialize_lcd(void)
 	 * DB1: 1 (I/D: increment)
 	 * DB0: 0 (S: Display shift OFF)
 	 */
-	lcd_command (0x06);
+	{ 20u, 0x06 },
 
 	/**
 	 * Display set
@@ -139,5 +155,71 @@ void initialize_lcd(void)
 	 * DB1: 0 (C: Cursor OFF)
 	 * DB0: 0 (B: Blink cursor OFF)
 	 */
-	lcd_command (0x0C);
+	{ 1u, 0x0C }
+};
+
+void lcd_run_sequence_P (const struct lcd_step *steps, uint8_t count)
+{
+	for (; count > 0; count--, steps++)
+	{
+		uint8_t wait = pgm_read_byte (&steps->wait_before);
+
+		for (; wait > 0; wait--)
+		{
+			_delay_us (LCD_WAIT_UNIT_US);
+		}
+
+		lcd_send_command (pgm_read_byte (&steps->cmd));
+	}
+
+	/* Let the last command complete */
+	_delay_us (LCD_WAIT_UNIT_US);
+}
+
+void lcd_write_P (const char *str)
+{
+	char curr_char = pgm_read_byte (str);
+
+	while (curr_char != '\0')
+	{
+		lcd_data (curr_char);
+		curr_char = pgm_read_byte (++str);
+	}
+}
+
+void lcd_goto (uint8_t line, uint8_t col)
+{
+	if (line == 0 || line > 2 || col >= 40)
+	{
+		/* Do nothing if the request is for an invalid position */
+		return;
+	}
+
+	/* Set DDRAM address: line 1 starts at 0x00 and line 2 at 0x40 */
+	lcd_quick_command (0x80 | ((line == 2) ? 0x40 : 0x00) | col);
+}
+
+void lcd_write (const char *buf, uint8_t len)
+{
+	for (; len > 0; len--)
+	{
+		lcd_data (*buf++);
+	}
+}
+
+void lcd_write_at (uint8_t line, uint8_t col, const char *buf, uint8_t len)
+{
+	if (line == 0 || line > 2 || col >= 40)
+	{
+		/* Do nothing rather than write at the current address */
+		return;
+	}
+
+	lcd_goto (line, col);
+	lcd_write (buf, len);
+}
+
+void initialize_lcd(void)
+{
+	lcd_run_sequence_P (lcd_init_sequence, LCD_INIT_SEQUENCE_LENGTH);
 }
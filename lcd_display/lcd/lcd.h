@@ -33,9 +33,34 @@
 
 #include <stdint.h>
 #include <avr/io.h>
+#include <avr/pgmspace.h>
 
 #define F_CPU 1000000UL
 
+/* Unit of the waits in a command sequence (see lcd_step) */
+#define LCD_WAIT_UNIT_US 100u
+
+/**
+ * lcd_step:
+ *
+ * A step of a command sequence kept in the flash: the time to wait
+ * (in units of LCD_WAIT_UNIT_US) before sending the command.
+ *
+ * Every command other than clear display and return home completes
+ * within one unit, so only the steps following them (or the first step
+ * after power-on) need a longer wait.
+ */
+struct lcd_step
+{
+	uint8_t wait_before;
+	uint8_t cmd;
+};
+
+#define LCD_INIT_SEQUENCE_LENGTH 8
+
+/* Initialisation sequence from the data sheet including the power-on wait */
+extern const struct lcd_step lcd_init_sequence[LCD_INIT_SEQUENCE_LENGTH] PROGMEM;
+
 /**
  * lcd_command:
  *
@@ -55,6 +80,16 @@
  */
 void lcd_command (uint8_t cmd);
 
+/**
+ * lcd_quick_command:
+ *
+ * @cmd: The command to be sent to the LCD
+ *
+ * Same as lcd_command but waits only LCD_WAIT_UNIT_US which is enough
+ * for every command other than clear display and return home.
+ */
+void lcd_quick_command (uint8_t cmd);
+
 /**
  * lcd_data:
  *
@@ -70,6 +105,27 @@ void lcd_command (uint8_t cmd);
  */
 void lcd_data (uint8_t data);
 
+/**
+ * lcd_send_command:
+ *
+ * @cmd: The command to be sent to the LCD
+ *
+ * Same as lcd_command but returns immediately after the command is
+ * latched by the LCD without waiting for it to be processed. The caller
+ * has to ensure that nothing is sent to the LCD till it is processed.
+ */
+void lcd_send_command (uint8_t cmd);
+
+/**
+ * lcd_send_data:
+ *
+ * @data: The data to be written to the DDRAM of the LCD.
+ *
+ * Same as lcd_data but returns immediately without waiting for the
+ * data to be processed.
+ */
+void lcd_send_data (uint8_t data);
+
 /**
  * lcd_select_line:
  *
@@ -83,6 +139,68 @@ void lcd_data (uint8_t data);
  */
 void lcd_goto_line_home (uint8_t line_num);
 
+/**
+ * lcd_run_sequence_P:
+ *
+ * @steps: the sequence of commands in the flash
+ * @count: number of steps in the sequence
+ *
+ * Send the commands in the sequence one after the other waiting before
+ * each as required by the step. The sequence is read directly from the
+ * flash and is never copied to the RAM.
+ *
+ * Note: The last command in the sequence must not be a long one
+ *       (clear display or return home).
+ */
+void lcd_run_sequence_P (const struct lcd_step *steps, uint8_t count);
+
+/**
+ * lcd_write_P:
+ *
+ * @str: NUL terminated string in the flash (e.g. PSTR("Hello"))
+ *
+ * Write the string at the current address of the LCD reading it
+ * directly from the flash.
+ */
+void lcd_write_P (const char *str);
+
+/**
+ * lcd_goto:
+ *
+ * @line_num: the line number (either 1 or 2)
+ * @col: the column (0 - 39)
+ *
+ * Set the DDRAM address to the given position. Unlike
+ * lcd_goto_line_home, waits only as long as the set DDRAM address
+ * command requires.
+ */
+void lcd_goto (uint8_t line_num, uint8_t col);
+
+/**
+ * lcd_write:
+ *
+ * @buf: the characters to be written (need not be NUL terminated)
+ * @len: number of characters
+ *
+ * Write the characters at the current address of the LCD one after the
+ * other. The address is auto-incremented by the LCD so it is set only
+ * once for the whole span.
+ */
+void lcd_write (const char *buf, uint8_t len);
+
+/**
+ * lcd_write_at:
+ *
+ * @line_num: the line number (either 1 or 2)
+ * @col: the column (0 - 39) of the first character
+ * @buf: the characters to be written (need not be NUL terminated)
+ * @len: number of characters
+ *
+ * Same as lcd_write but starting at the given position. Nothing is
+ * written if the position is invalid.
+ */
+void lcd_write_at (uint8_t line_num, uint8_t col, const char *buf, uint8_t len);
+
 /**
  * initialize_lcd:
  *
@@ -0,0 +1,91 @@
+#include "lcd_async.h"
+#include "../../scheduler/sched/sched.h"
+
+/*
+ * Wait times in fine ticks. One tick is added as the wait could begin
+ * anywhere within a fine tick.
+ */
+#define WAIT_US(us) (SCHED_US_TO_FINE_TICKS (us) + 1u)
+#define WAIT_MS(ms) (SCHED_MS_TO_FINE_TICKS (ms) + 1u)
+
+/* Time taken by the clear display and return home commands (1.52ms) */
+#define WAIT_LONG_COMMAND WAIT_MS (2u)
+
+/* Time taken by the rest of the commands and data writes (37us, 43us) */
+#define WAIT_SHORT_COMMAND WAIT_US (100u)
+
+static inline void
+lcd_wait_start (struct lcd_pt *pt, uint16_t wait)
+{
+	pt->wait_start = SCHED_fine_ticks ();
+	pt->wait = wait;
+}
+
+static inline _Bool
+lcd_wait_over (const struct lcd_pt *pt)
+{
+	return (uint16_t) (SCHED_fine_ticks () - pt->wait_start) >= pt->wait;
+}
+
+static inline uint16_t
+lcd_command_wait (uint8_t cmd)
+{
+	/* Clear display (0x01) and return home (0x02, 0x03) */
+	return (cmd <= 0x03) ? WAIT_LONG_COMMAND : WAIT_SHORT_COMMAND;
+}
+
+int8_t
+lcd_run_sequence_async (struct lcd_pt *pt, const struct lcd_step *steps,
+                        uint8_t count)
+{
+	PT_BEGIN (pt->lc);
+
+	for (pt->index = 0; pt->index < count; pt->index++)
+	{
+		lcd_wait_start (pt, pgm_read_byte (&steps[pt->index].wait_before) *
+		                    SCHED_US_TO_FINE_TICKS (LCD_WAIT_UNIT_US) + 1u);
+		PT_WAIT_UNTIL (pt->lc, lcd_wait_over (pt));
+
+		lcd_send_command (pgm_read_byte (&steps[pt->index].cmd));
+	}
+
+	/* Let the last command complete */
+	lcd_wait_start (pt, WAIT_SHORT_COMMAND);
+	PT_WAIT_UNTIL (pt->lc, lcd_wait_over (pt));
+
+	PT_END (pt->lc);
+}
+
+int8_t
+initialize_lcd_async (struct lcd_pt *pt)
+{
+	return lcd_run_sequence_async (pt, lcd_init_sequence,
+	                               LCD_INIT_SEQUENCE_LENGTH);
+}
+
+int8_t
+lcd_command_async (struct lcd_pt *pt, uint8_t cmd)
+{
+	PT_BEGIN (pt->lc);
+
+	lcd_send_command (cmd);
+	lcd_wait_start (pt, lcd_command_wait (cmd));
+	PT_WAIT_UNTIL (pt->lc, lcd_wait_over (pt));
+
+	PT_END (pt->lc);
+}
+
+int8_t
+lcd_write_async (struct lcd_pt *pt, const char *data, uint8_t len)
+{
+	PT_BEGIN (pt->lc);
+
+	for (pt->index = 0; pt->index < len; pt->index++)
+	{
+		lcd_send_data (data[pt->index]);
+		lcd_wait_start (pt, WAIT_SHORT_COMMAND);
+		PT_WAIT_UNTIL (pt->lc, lcd_wait_over (pt));
+	}
+
+	PT_END (pt->lc);
+}
@@ -0,0 +1,119 @@
+#ifndef KS_LCD_ASYNC_ATMEGA32
+#define KS_LCD_ASYNC_ATMEGA32
+
+/**
+ * Non-blocking versions of the LCD functions written as stackless
+ * coroutines (see scheduler/pt/pt.h).
+ *
+ * Instead of calling _delay_ms/_delay_us the functions return
+ * PT_WAITING at every point where the LCD has to be given time and
+ * continue from there when invoked again. They return PT_DONE once the
+ * operation is complete.
+ *
+ * Notes:
+ *
+ * 1. The waits are timed using the fine ticks of the scheduler, so
+ *    SCHED_init must have been invoked and interrupts enabled. Even
+ *    with SCHED_XTAL_TICK the fine ticks come from Timer1 clocked by
+ *    the RC oscillator, so the waits are not corrected against the
+ *    crystal: an RC clock running fast shortens them in proportion.
+ *
+ * 2. The LCD has a single bus, so only one operation (on any one
+ *    'struct lcd_pt') may be in progress at a time.
+ *
+ * 3. The arguments must be the same on every invocation till the
+ *    operation is complete.
+ *
+ * 4. The port configuration is the same as that of lcd.h.
+ */
+
+#include <stdint.h>
+#include "lcd.h"
+#include "../../scheduler/pt/pt.h"
+
+/**
+ * lcd_pt:
+ *
+ * State of an LCD operation in progress.
+ */
+struct lcd_pt
+{
+	uint16_t lc;
+
+	/* Start and length of the current wait in fine ticks */
+	uint16_t wait_start;
+	uint16_t wait;
+
+	/* Position within the sequence being sent */
+	uint8_t index;
+};
+
+/**
+ * lcd_pt_init:
+ *
+ * @pt: the state to be initialised
+ *
+ * Initialise the state before starting a new operation.
+ */
+static inline void
+lcd_pt_init (struct lcd_pt *pt)
+{
+	PT_INIT (pt->lc);
+}
+
+/**
+ * lcd_run_sequence_async:
+ *
+ * @pt: state of the operation
+ * @steps: the sequence of commands in the flash
+ * @count: number of steps in the sequence
+ *
+ * Asynchronous version of lcd_run_sequence_P.
+ *
+ * Returns: PT_WAITING till the sequence is complete and then PT_DONE.
+ */
+int8_t
+lcd_run_sequence_async (struct lcd_pt *pt, const struct lcd_step *steps,
+                        uint8_t count);
+
+/**
+ * initialize_lcd_async:
+ *
+ * @pt: state of the operation
+ *
+ * Asynchronous version of initialize_lcd. Includes the power-on wait.
+ *
+ * Returns: PT_WAITING till the initialisation is complete and then PT_DONE.
+ */
+int8_t
+initialize_lcd_async (struct lcd_pt *pt);
+
+/**
+ * lcd_command_async:
+ *
+ * @pt: state of the operation
+ * @cmd: the command to be sent
+ *
+ * Asynchronous version of lcd_command. Waits only as long as the
+ * given command requires.
+ *
+ * Returns: PT_WAITING till the command is processed and then PT_DONE.
+ */
+int8_t
+lcd_command_async (struct lcd_pt *pt, uint8_t cmd);
+
+/**
+ * lcd_write_async:
+ *
+ * @pt: state of the operation
+ * @data: the characters to be written
+ * @len: number of characters
+ *
+ * Write the characters at the current address yielding after each one.
+ *
+ * Returns: PT_WAITING till all the characters are written and then PT_DONE.
+ */
+int8_t
+lcd_write_async (struct lcd_pt *pt, const char *data, uint8_t len);
+
+#endif
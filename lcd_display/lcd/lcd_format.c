@@ -0,0 +1,150 @@
+#include "lcd_format.h"
+
+/* Maximum number of digits of a 16-bit number */
+#define MAX_DIGITS 5
+
+static const uint16_t powers_of_ten[MAX_DIGITS] PROGMEM = {
+	10000, 1000, 100, 10, 1
+};
+
+/**
+ * lcd_format_digits:
+ *
+ * @digits: used to return the digits (most significant first)
+ * @value: the number to convert
+ * @min_digits: minimum number of digits (leading zeroes are added)
+ *
+ * Convert the number to decimal digits by repeated subtraction.
+ *
+ * Returns: the number of digits.
+ */
+static uint8_t lcd_format_digits (char *digits, uint16_t value, uint8_t min_digits)
+{
+	uint8_t count = 0, i = 0;
+
+	for (i = 0; i < MAX_DIGITS; i++)
+	{
+		const uint16_t power = pgm_read_word (&powers_of_ten[i]);
+		char digit = '0';
+
+		while (value >= power)
+		{
+			value -= power;
+			digit++;
+		}
+
+		/* Skip the leading zeroes not required */
+		if (count == 0 && digit == '0' && i < MAX_DIGITS - min_digits && i < MAX_DIGITS - 1)
+		{
+			continue;
+		}
+
+		digits[count++] = digit;
+	}
+
+	return count;
+}
+
+/**
+ * lcd_format_pad:
+ *
+ * Append @pad so that @len characters that follow take up @width.
+ */
+static void lcd_format_pad (struct lcd_format *fmt, uint8_t len, uint8_t width, char pad)
+{
+	for (; len < width; len++)
+	{
+		lcd_format_char (fmt, pad);
+	}
+}
+
+void lcd_format_init (struct lcd_format *fmt)
+{
+	fmt->len = 0;
+}
+
+void lcd_format_char (struct lcd_format *fmt, char c)
+{
+	if (fmt->len < LCD_FORMAT_BUFFER_SIZE)
+	{
+		fmt->text[fmt->len++] = c;
+	}
+}
+
+void lcd_format_P (struct lcd_format *fmt, const char *str)
+{
+	char curr_char = pgm_read_byte (str);
+
+	while (curr_char != '\0')
+	{
+		lcd_format_char (fmt, curr_char);
+		curr_char = pgm_read_byte (++str);
+	}
+}
+
+void lcd_format_uint (struct lcd_format *fmt, uint16_t value, uint8_t width, char pad)
+{
+	char digits[MAX_DIGITS];
+	const uint8_t count = lcd_format_digits (digits, value, 1);
+	uint8_t i = 0;
+
+	lcd_format_pad (fmt, count, width, pad);
+
+	for (i = 0; i < count; i++)
+	{
+		lcd_format_char (fmt, digits[i]);
+	}
+}
+
+void lcd_format_int (struct lcd_format *fmt, int16_t value, uint8_t width)
+{
+	lcd_format_fixed (fmt, value, 0, width);
+}
+
+void lcd_format_bcd (struct lcd_format *fmt, uint8_t bcd)
+{
+	lcd_format_char (fmt, (bcd >> 4) + '0');
+	lcd_format_char (fmt, (bcd & 0x0F) + '0');
+}
+
+void lcd_format_fixed (struct lcd_format *fmt, int16_t value, uint8_t decimals, uint8_t width)
+{
+	char digits[MAX_DIGITS];
+	const _Bool negative = (value < 0);
+
+	/* The magnitude of -32768 fits in 16 bits only when unsigned */
+	const uint16_t magnitude = negative ? -(uint16_t) value : (uint16_t) value;
+	uint8_t count = 0, len = 0, i = 0;
+
+	if (decimals >= MAX_DIGITS)
+	{
+		decimals = MAX_DIGITS - 1;
+	}
+
+	/* At least one digit before the point */
+	count = lcd_format_digits (digits, magnitude, decimals + 1);
+	len = count + negative + (decimals > 0);
+
+	lcd_format_pad (fmt, len, width, ' ');
+
+	if (negative)
+	{
+		lcd_format_char (fmt, '-');
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		if (i == count - decimals && decimals > 0)
+		{
+			lcd_format_char (fmt, '.');
+		}
+
+		lcd_format_char (fmt, digits[i]);
+	}
+}
+
+void lcd_format_flush (struct lcd_format *fmt, uint8_t line, uint8_t col)
+{
+	lcd_write_at (line, col, fmt->text, fmt->len);
+	fmt->len = 0;
+}
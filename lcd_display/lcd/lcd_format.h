@@ -0,0 +1,127 @@
+#ifndef KS_LCD_FORMAT_ATMEGA32
+#define KS_LCD_FORMAT_ATMEGA32
+
+/**
+ * Formatting of text for the LCD into a line buffer.
+ *
+ * The text of a field (or a whole line) is composed in a buffer and then
+ * written to the LCD in one pass using lcd_format_flush so that the
+ * address is set only once.
+ *
+ * Numbers are converted by repeated subtraction of the powers of ten.
+ * The ATMEGA32 has no divide instruction so this is much cheaper than
+ * the division (and modulo) by 10 for every digit.
+ *
+ * Characters that don't fit in the buffer are dropped.
+ *
+ * Example:
+ *
+ * 	struct lcd_format fmt;
+ *
+ * 	lcd_format_init (&fmt);
+ * 	lcd_format_P (&fmt, PSTR("T:"));
+ * 	lcd_format_fixed (&fmt, -125, 1, 6);
+ * 	lcd_format_flush (&fmt, 2, 0);
+ *
+ * shows "T: -12.5" on the second line.
+ */
+
+#include <stdint.h>
+#include "lcd.h"
+
+/* Columns in the DDRAM of a line */
+#define LCD_FORMAT_BUFFER_SIZE 40
+
+/**
+ * lcd_format:
+ *
+ * @text: the characters composed so far
+ * @len: number of characters composed so far
+ */
+struct lcd_format
+{
+	char text[LCD_FORMAT_BUFFER_SIZE];
+	uint8_t len;
+};
+
+/**
+ * lcd_format_init:
+ *
+ * @fmt: the buffer
+ *
+ * Empty the buffer.
+ */
+void lcd_format_init (struct lcd_format *fmt);
+
+/**
+ * lcd_format_char:
+ *
+ * @fmt: the buffer
+ * @c: the character to append
+ */
+void lcd_format_char (struct lcd_format *fmt, char c);
+
+/**
+ * lcd_format_P:
+ *
+ * @fmt: the buffer
+ * @str: NUL terminated string in the flash (e.g. PSTR("Hello"))
+ */
+void lcd_format_P (struct lcd_format *fmt, const char *str);
+
+/**
+ * lcd_format_uint:
+ *
+ * @fmt: the buffer
+ * @value: the number to append
+ * @width: minimum number of characters (0 for no padding)
+ * @pad: character used to pad on the left (e.g. ' ' or '0')
+ */
+void lcd_format_uint (struct lcd_format *fmt, uint16_t value, uint8_t width, char pad);
+
+/**
+ * lcd_format_int:
+ *
+ * @fmt: the buffer
+ * @value: the number to append
+ * @width: minimum number of characters including the sign
+ *
+ * The number is padded on the left with spaces.
+ */
+void lcd_format_int (struct lcd_format *fmt, int16_t value, uint8_t width);
+
+/**
+ * lcd_format_bcd:
+ *
+ * @fmt: the buffer
+ * @bcd: two BCD digits (e.g. the value of an RTC register)
+ *
+ * Append both the digits (tens first) without any conversion.
+ */
+void lcd_format_bcd (struct lcd_format *fmt, uint8_t bcd);
+
+/**
+ * lcd_format_fixed:
+ *
+ * @fmt: the buffer
+ * @value: the number in units of 10^-@decimals (e.g. 2345 for 23.45)
+ * @decimals: number of digits after the decimal point (0 - 4)
+ * @width: minimum number of characters including the sign and the point
+ *
+ * Append a fixed-point number padded on the left with spaces.
+ */
+void lcd_format_fixed (struct lcd_format *fmt, int16_t value, uint8_t decimals, uint8_t width);
+
+/**
+ * lcd_format_flush:
+ *
+ * @fmt: the buffer
+ * @line_num: the line number (either 1 or 2)
+ * @col: the column of the first character
+ *
+ * Write the composed text at the given position (see lcd_write_at) and
+ * empty the buffer.
+ */
+void lcd_format_flush (struct lcd_format *fmt, uint8_t line_num, uint8_t col);
+
+#endif
@@ -0,0 +1,233 @@
+#include "lcd_glyph.h"
+
+#define NO_GLYPH 0xFFu
+
+static const struct lcd_glyph *glyph_library;
+static uint8_t glyph_count;
+
+/* Glyph held in each CGRAM slot */
+static uint8_t slot_glyph[LCD_GLYPH_SLOTS];
+
+/* Value of use_clock when each slot was last used */
+static uint16_t slot_last_use[LCD_GLYPH_SLOTS];
+static uint16_t use_clock;
+
+/* Glyph shown in each cell of the screen */
+static uint8_t cell_glyph[LCD_GLYPH_LINES][LCD_GLYPH_COLUMNS];
+
+static struct lcd_glyph_stats stats;
+
+void lcd_glyph_init (const struct lcd_glyph *library, uint8_t count)
+{
+	uint8_t slot = 0, line = 0, col = 0;
+
+	glyph_library = library;
+	glyph_count = count;
+	use_clock = 0;
+
+	for (; slot < LCD_GLYPH_SLOTS; slot++)
+	{
+		slot_glyph[slot] = NO_GLYPH;
+		slot_last_use[slot] = 0;
+	}
+
+	for (; line < LCD_GLYPH_LINES; line++)
+	{
+		for (col = 0; col < LCD_GLYPH_COLUMNS; col++)
+		{
+			cell_glyph[line][col] = NO_GLYPH;
+		}
+	}
+
+	stats.hits = stats.misses = stats.evictions = 0;
+}
+
+/**
+ * lcd_glyph_on_screen:
+ *
+ * Returns: whether any cell shows the glyph.
+ */
+static _Bool lcd_glyph_on_screen (uint8_t glyph)
+{
+	uint8_t line = 0, col = 0;
+
+	for (; line < LCD_GLYPH_LINES; line++)
+	{
+		for (col = 0; col < LCD_GLYPH_COLUMNS; col++)
+		{
+			if (cell_glyph[line][col] == glyph)
+			{
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * lcd_glyph_victim:
+ *
+ * Choose the slot to be replaced: a free slot if any, else the least
+ * recently used slot not on the screen, else the least recently used slot.
+ */
+static uint8_t lcd_glyph_victim (void)
+{
+	uint8_t slot = 0;
+	uint8_t lru_slot = 0, lru_off_screen = NO_GLYPH;
+	uint16_t lru_age = 0, lru_off_screen_age = 0;
+
+	for (; slot < LCD_GLYPH_SLOTS; slot++)
+	{
+		const uint16_t age = use_clock - slot_last_use[slot];
+
+		if (slot_glyph[slot] == NO_GLYPH)
+		{
+			return slot;
+		}
+
+		if (age >= lru_age)
+		{
+			lru_age = age;
+			lru_slot = slot;
+		}
+
+		if (age >= lru_off_screen_age &&
+		    !lcd_glyph_on_screen (slot_glyph[slot]))
+		{
+			lru_off_screen_age = age;
+			lru_off_screen = slot;
+		}
+	}
+
+	return (lru_off_screen != NO_GLYPH) ? lru_off_screen : lru_slot;
+}
+
+/**
+ * lcd_glyph_evict:
+ *
+ * Rewrite the cells showing the glyph in the slot with its fallback
+ * character before the slot is replaced.
+ */
+static void lcd_glyph_evict (uint8_t slot)
+{
+	const uint8_t glyph = slot_glyph[slot];
+	uint8_t line = 0, col = 0;
+	_Bool evicted = 0;
+
+	if (glyph == NO_GLYPH)
+	{
+		return;
+	}
+
+	for (; line < LCD_GLYPH_LINES; line++)
+	{
+		for (col = 0; col < LCD_GLYPH_COLUMNS; col++)
+		{
+			if (cell_glyph[line][col] != glyph)
+			{
+				continue;
+			}
+
+			lcd_goto (line + 1, col);
+			lcd_data (pgm_read_byte (&glyph_library[glyph].fallback));
+			cell_glyph[line][col] = NO_GLYPH;
+			evicted = 1;
+		}
+	}
+
+	if (evicted)
+	{
+		stats.evictions++;
+	}
+}
+
+/**
+ * lcd_glyph_upload:
+ *
+ * Write the pattern of the glyph into the CGRAM of the slot.
+ */
+static void lcd_glyph_upload (uint8_t slot, uint8_t glyph)
+{
+	const uint8_t *pattern = glyph_library[glyph].pattern;
+	uint8_t row = 0;
+
+	/* Set CGRAM address; the address auto-increments on every write */
+	lcd_quick_command (0x40 | (slot << 3));
+
+	for (; row < LCD_GLYPH_ROWS; row++)
+	{
+		lcd_data (pgm_read_byte (pattern + row));
+	}
+}
+
+/**
+ * lcd_glyph_slot:
+ *
+ * Returns: the slot holding the glyph, uploading it if required.
+ */
+static uint8_t lcd_glyph_slot (uint8_t glyph)
+{
+	uint8_t slot = 0;
+
+	use_clock++;
+
+	for (; slot < LCD_GLYPH_SLOTS; slot++)
+	{
+		if (slot_glyph[slot] == glyph)
+		{
+			stats.hits++;
+			slot_last_use[slot] = use_clock;
+			return slot;
+		}
+	}
+
+	stats.misses++;
+
+	slot = lcd_glyph_victim ();
+	lcd_glyph_evict (slot);
+	lcd_glyph_upload (slot, glyph);
+
+	slot_glyph[slot] = glyph;
+	slot_last_use[slot] = use_clock;
+
+	return slot;
+}
+
+void lcd_glyph_put (uint8_t line, uint8_t col, uint8_t glyph)
+{
+	uint8_t slot = 0;
+
+	if (line == 0 || line > LCD_GLYPH_LINES || col >= LCD_GLYPH_COLUMNS ||
+	    glyph >= glyph_count)
+	{
+		/* Do nothing if the request is invalid */
+		return;
+	}
+
+	/* The cell no longer shows the glyph it had; it is not to be evicted */
+	cell_glyph[line - 1][col] = NO_GLYPH;
+
+	slot = lcd_glyph_slot (glyph);
+
+	/* The upload leaves the address counter in the CGRAM; always re-address */
+	lcd_goto (line, col);
+	lcd_data (slot);
+
+	cell_glyph[line - 1][col] = glyph;
+}
+
+void lcd_glyph_forget (uint8_t line, uint8_t col)
+{
+	if (line == 0 || line > LCD_GLYPH_LINES || col >= LCD_GLYPH_COLUMNS)
+	{
+		return;
+	}
+
+	cell_glyph[line - 1][col] = NO_GLYPH;
+}
+
+const struct lcd_glyph_stats *lcd_glyph_get_stats (void)
+{
+	return &stats;
+}
@@ -0,0 +1,101 @@
+#ifndef KS_LCD_GLYPH_ATMEGA32
+#define KS_LCD_GLYPH_ATMEGA32
+
+/**
+ * Cache of custom characters (glyphs) in the CGRAM of the LCD.
+ *
+ * The HD44780 has only 8 CGRAM slots (character codes 0 - 7). The glyphs
+ * are kept in a library in the flash and are identified by their index
+ * in the library. A glyph is uploaded to a slot only when it is not
+ * already present in one (a miss). On a miss the least recently used
+ * slot is replaced, preferring slots that are not shown on the screen.
+ *
+ * Changing the pattern of a slot changes every cell showing it. So,
+ * when a slot in use on the screen has to be replaced, the cells showing
+ * the old glyph are rewritten with the fallback character of the glyph.
+ *
+ * The cells written using lcd_glyph_put are tracked for this purpose.
+ * A cell holding a glyph that is overwritten by other means should be
+ * reported using lcd_glyph_forget.
+ *
+ * Lines are numbered 1 and 2 as in lcd.h; columns 0 - 15.
+ */
+
+#include <stdint.h>
+#include "lcd.h"
+
+#define LCD_GLYPH_SLOTS 8
+#define LCD_GLYPH_ROWS 8
+
+#define LCD_GLYPH_LINES 2
+#define LCD_GLYPH_COLUMNS 16
+
+/**
+ * lcd_glyph:
+ *
+ * Entry of the glyph library (in the flash).
+ *
+ * @pattern: the 5 dot wide rows (bits 4 - 0) from top to bottom
+ * @fallback: character shown when the glyph cannot be kept in the CGRAM
+ */
+struct lcd_glyph
+{
+	uint8_t pattern[LCD_GLYPH_ROWS];
+	char fallback;
+};
+
+/**
+ * lcd_glyph_stats:
+ *
+ * Counters of the cache lookups.
+ */
+struct lcd_glyph_stats
+{
+	uint16_t hits;
+	uint16_t misses;
+
+	/* Misses that had to replace a glyph shown on the screen */
+	uint16_t evictions;
+};
+
+/**
+ * lcd_glyph_init:
+ *
+ * @library: the glyph library in the flash
+ * @count: number of glyphs in the library (at most 255)
+ *
+ * Initialise the cache to be empty. Invoke after initialize_lcd and
+ * after clearing the display.
+ */
+void lcd_glyph_init (const struct lcd_glyph *library, uint8_t count);
+
+/**
+ * lcd_glyph_put:
+ *
+ * @line_num: the line number (either 1 or 2)
+ * @col: the column (0 - 15)
+ * @glyph: index of the glyph in the library
+ *
+ * Show the glyph at the given position uploading it to the CGRAM if
+ * required.
+ */
+void lcd_glyph_put (uint8_t line_num, uint8_t col, uint8_t glyph);
+
+/**
+ * lcd_glyph_forget:
+ *
+ * @line_num: the line number (either 1 or 2)
+ * @col: the column (0 - 15)
+ *
+ * Note that the cell no longer shows a glyph.
+ */
+void lcd_glyph_forget (uint8_t line_num, uint8_t col);
+
+/**
+ * lcd_glyph_get_stats:
+ *
+ * Returns: the lookup counters since lcd_glyph_init.
+ */
+const struct lcd_glyph_stats *lcd_glyph_get_stats (void);
+
+#endif
@@ -0,0 +1,70 @@
+#include "lcd_marquee.h"
+#include "../../scheduler/sched/sched.h"
+
+/*
+ * Cursor or display shift:
+ *
+ * DB3: 1 (S/C: shift the display)
+ * DB2: 1 (R/L: right) or 0 (left)
+ */
+#define SHIFT_DISPLAY_LEFT 0x18
+#define SHIFT_DISPLAY_RIGHT 0x1C
+
+static int8_t marquee_task = -1;
+static uint8_t shift_cmd = SHIFT_DISPLAY_LEFT;
+
+void lcd_marquee_load (uint8_t line, const char *text, uint8_t len)
+{
+	uint8_t col = 0;
+
+	if (line == 0 || line > 2)
+	{
+		/* Do nothing if the request is for an invalid line */
+		return;
+	}
+
+	if (len > LCD_MARQUEE_COLUMNS)
+	{
+		len = LCD_MARQUEE_COLUMNS;
+	}
+
+	lcd_goto (line, 0);
+
+	/* The address counter increments after every write */
+	for (; col < LCD_MARQUEE_COLUMNS; col++)
+	{
+		lcd_data ((col < len) ? text[col] : ' ');
+	}
+}
+
+static void lcd_marquee_step (void)
+{
+	lcd_quick_command (shift_cmd);
+}
+
+int8_t lcd_marquee_start (uint16_t period, uint8_t direction)
+{
+	lcd_marquee_stop ();
+
+	shift_cmd = (direction == LCD_MARQUEE_RIGHT) ? SHIFT_DISPLAY_RIGHT :
+	                                               SHIFT_DISPLAY_LEFT;
+
+	marquee_task = SCHED_add (lcd_marquee_step, period, period,
+	                          SCHED_PRIORITY_LOW);
+
+	return (marquee_task < 0) ? 1 : 0;
+}
+
+void lcd_marquee_stop (void)
+{
+	if (marquee_task < 0)
+	{
+		return;
+	}
+
+	SCHED_remove (marquee_task);
+	marquee_task = -1;
+
+	/* Return home also undoes the display shift */
+	lcd_command (0x02);
+}
@@ -0,0 +1,67 @@
+#ifndef KS_LCD_MARQUEE_ATMEGA32
+#define KS_LCD_MARQUEE_ATMEGA32
+
+/**
+ * Scrolling of text longer than the 16 visible columns using the
+ * display shift of the LCD.
+ *
+ * Each line of the HD44780 has 40 columns of DDRAM of which only 16 are
+ * visible. The text is written into the DDRAM once and is then scrolled
+ * by shifting the display (one ~40us command per step) from a periodic
+ * task of the scheduler. The DDRAM of a line is circular so the text
+ * wraps around after 40 steps.
+ *
+ * Notes:
+ *
+ * 1. The display shift applies to both the lines. A line that should
+ *    not scroll cannot be shown while the marquee is running.
+ *
+ * 2. The scheduler (scheduler/sched/sched.h) must be initialised.
+ *
+ * 3. While the marquee runs, the visible columns do not correspond to
+ *    the DDRAM addresses used by lcd_goto.
+ */
+
+#include <stdint.h>
+#include "lcd.h"
+
+#define LCD_MARQUEE_COLUMNS 40
+
+/* Direction of the scroll */
+#define LCD_MARQUEE_LEFT 0
+#define LCD_MARQUEE_RIGHT 1
+
+/**
+ * lcd_marquee_load:
+ *
+ * @line_num: the line number (either 1 or 2)
+ * @text: the text to be shown
+ * @len: length of the text (at most LCD_MARQUEE_COLUMNS)
+ *
+ * Write the text into the whole DDRAM of the line padding it with
+ * spaces. The padding forms the gap between the end of the text and
+ * its beginning as it wraps around. Does nothing for an invalid line.
+ */
+void lcd_marquee_load (uint8_t line_num, const char *text, uint8_t len);
+
+/**
+ * lcd_marquee_start:
+ *
+ * @period: time in ms between the scroll steps
+ * @direction: LCD_MARQUEE_LEFT or LCD_MARQUEE_RIGHT
+ *
+ * Start scrolling the display. Restarts the marquee if it is running.
+ *
+ * Returns: 0 if the marquee was started. Non-zero value if the
+ *          scheduler had no free slot.
+ */
+int8_t lcd_marquee_start (uint16_t period, uint8_t direction);
+
+/**
+ * lcd_marquee_stop:
+ *
+ * Stop scrolling and return the display to its unshifted position.
+ */
+void lcd_marquee_stop (void);
+
+#endif
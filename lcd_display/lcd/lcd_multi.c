@@ -0,0 +1,99 @@
+#include "lcd_multi.h"
+#include <util/delay.h>
+
+/**
+ * Notes:
+ *
+ * 	R: 1
+ * 	W: 0
+ *
+ * 	DB: Data Bus of LCD
+ */
+
+#define RW_PIN (1<<1)
+#define RS_PIN (1<<2)
+
+/**
+ * lcd_multi_strobe:
+ *
+ * Write the byte to the data bus and latch it in the selected displays
+ * using the falling edge of their EN pins.
+ */
+static void lcd_multi_strobe (uint8_t displays, uint8_t rs, uint8_t byte)
+{
+	displays &= LCD_EN_ALL;
+
+	/* W, RS as required and EN of the selected displays */
+	PORTA = (PORTA & ~(LCD_EN_ALL | RW_PIN | RS_PIN)) | rs | displays;
+
+	PORTD = byte;
+
+	/* clear the EN pins */
+	PORTA &= ~displays;
+}
+
+void lcd_multi_command (uint8_t displays, uint8_t cmd)
+{
+	lcd_multi_strobe (displays, 0, cmd);
+
+	/* Clear display (0x01) and return home (0x02, 0x03) take 1.52ms */
+	if (cmd <= 0x03)
+	{
+		_delay_ms (2);
+	}
+	else
+	{
+		_delay_us (LCD_WAIT_UNIT_US);
+	}
+}
+
+void lcd_multi_data (uint8_t displays, uint8_t data)
+{
+	lcd_multi_strobe (displays, RS_PIN, data);
+
+	_delay_us (LCD_WAIT_UNIT_US);
+}
+
+void lcd_multi_write (uint8_t displays, const char *data, uint8_t len)
+{
+	for (; len > 0; len--)
+	{
+		lcd_multi_data (displays, *data++);
+	}
+}
+
+void lcd_multi_goto (uint8_t displays, uint8_t line, uint8_t col)
+{
+	if (line == 0 || line > 2 || col >= 40)
+	{
+		/* Do nothing if the request is for an invalid position */
+		return;
+	}
+
+	lcd_multi_command (displays, 0x80 | ((line == 2) ? 0x40 : 0x00) | col);
+}
+
+void lcd_multi_run_sequence_P (uint8_t displays, const struct lcd_step *steps,
+                               uint8_t count)
+{
+	for (; count > 0; count--, steps++)
+	{
+		uint8_t wait = pgm_read_byte (&steps->wait_before);
+
+		for (; wait > 0; wait--)
+		{
+			_delay_us (LCD_WAIT_UNIT_US);
+		}
+
+		lcd_multi_strobe (displays, 0, pgm_read_byte (&steps->cmd));
+	}
+
+	/* Let the last command complete */
+	_delay_us (LCD_WAIT_UNIT_US);
+}
+
+void initialize_lcd_multi (uint8_t displays)
+{
+	lcd_multi_run_sequence_P (displays, lcd_init_sequence,
+	                          LCD_INIT_SEQUENCE_LENGTH);
+}
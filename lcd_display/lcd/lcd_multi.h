@@ -0,0 +1,108 @@
+#ifndef KS_LCD_MULTI_ATMEGA32
+#define KS_LCD_MULTI_ATMEGA32
+
+/*
+ * Helper functions to drive several LCDs that share the data bus and
+ * the RS/RW lines but have separate enable (EN) lines.
+ *
+ * Every function takes a mask of the EN pins (LCD_EN_*) of the displays
+ * to be written. All the selected EN pins are strobed together so the
+ * same bus write reaches all of them at once; e.g. initialising all the
+ * displays takes as long as initialising one.
+ *
+ * Port configurations:
+ *
+ * PORTD (0-7) - data pins shared by all the LCDs
+ * PORTA:
+ *
+ * 	Pin 0: Enable pin of LCD 0 (same as lcd.h)
+ * 	Pin 1: Read/Write pin of all the LCDs
+ * 	Pin 2: RS pin of all the LCDs
+ * 	Pin 3: Enable pin of LCD 1
+ * 	Pin 4: Enable pin of LCD 2
+ * 	Pin 5: Enable pin of LCD 3
+ *
+ * Notes:
+ *
+ * 1. The pins of PORTA listed above and all the pins of PORTD have to be
+ *    initialized for output before invoking any of the functions.
+ *
+ * 2. Only the pins listed above are changed in PORTA, so the rest of
+ *    its pins (e.g. the I2C lines) could be used for other purposes.
+ */
+
+#include <stdint.h>
+#include "lcd.h"
+
+#define LCD_EN_0 (1<<0)
+#define LCD_EN_1 (1<<3)
+#define LCD_EN_2 (1<<4)
+#define LCD_EN_3 (1<<5)
+
+#define LCD_EN_ALL (LCD_EN_0 | LCD_EN_1 | LCD_EN_2 | LCD_EN_3)
+
+/**
+ * lcd_multi_command:
+ *
+ * @displays: mask of the EN pins of the displays
+ * @cmd: The command to be sent
+ *
+ * Send the command to all the selected displays at once and wait for
+ * as long as the command requires.
+ */
+void lcd_multi_command (uint8_t displays, uint8_t cmd);
+
+/**
+ * lcd_multi_data:
+ *
+ * @displays: mask of the EN pins of the displays
+ * @data: The data to be written to the DDRAM
+ *
+ * Write the data to all the selected displays at once.
+ */
+void lcd_multi_data (uint8_t displays, uint8_t data);
+
+/**
+ * lcd_multi_write:
+ *
+ * @displays: mask of the EN pins of the displays
+ * @data: the characters to be written
+ * @len: number of characters
+ *
+ * Write the characters at the current address of the selected displays.
+ */
+void lcd_multi_write (uint8_t displays, const char *data, uint8_t len);
+
+/**
+ * lcd_multi_goto:
+ *
+ * @displays: mask of the EN pins of the displays
+ * @line_num: the line number (either 1 or 2)
+ * @col: the column (0 - 39)
+ *
+ * Set the DDRAM address of the selected displays.
+ */
+void lcd_multi_goto (uint8_t displays, uint8_t line_num, uint8_t col);
+
+/**
+ * lcd_multi_run_sequence_P:
+ *
+ * @displays: mask of the EN pins of the displays
+ * @steps: the sequence of commands in the flash
+ * @count: number of steps in the sequence
+ *
+ * Same as lcd_run_sequence_P for the selected displays.
+ */
+void lcd_multi_run_sequence_P (uint8_t displays, const struct lcd_step *steps,
+                               uint8_t count);
+
+/**
+ * initialize_lcd_multi:
+ *
+ * @displays: mask of the EN pins of the displays
+ *
+ * Initialize all the selected displays at once.
+ */
+void initialize_lcd_multi (uint8_t displays);
+
+#endif
@@ -0,0 +1,203 @@
+#include "lcd_screen.h"
+
+#define WINDOWS 2
+#define NO_PAGE 0xFFu
+
+#define RETURN_HOME 0x02
+#define SHIFT_DISPLAY_LEFT 0x18
+
+static char pages[LCD_SCREEN_PAGES][LCD_SCREEN_LINES][LCD_SCREEN_COLUMNS];
+
+/* What each window of the DDRAM holds */
+static char ddram[WINDOWS][LCD_SCREEN_LINES][LCD_SCREEN_COLUMNS];
+
+/* Page held by each window */
+static uint8_t window_page[WINDOWS];
+
+/* Window shown by the display shift */
+static uint8_t visible_window;
+
+/**
+ * lcd_screen_sync:
+ *
+ * @window: the window to be updated
+ *
+ * Send the cells of the window that differ from its page.
+ *
+ * Returns: the number of cells sent.
+ */
+static uint8_t lcd_screen_sync (uint8_t window)
+{
+	const uint8_t page = window_page[window];
+	uint8_t line = 0, col = 0, sent = 0;
+
+	if (page == NO_PAGE)
+	{
+		return 0;
+	}
+
+	for (line = 0; line < LCD_SCREEN_LINES; line++)
+	{
+		/* Whether the address of the LCD is that of the current cell */
+		_Bool addressed = 0;
+
+		for (col = 0; col < LCD_SCREEN_COLUMNS; col++)
+		{
+			const char c = pages[page][line][col];
+
+			if (c == ddram[window][line][col])
+			{
+				addressed = 0;
+				continue;
+			}
+
+			if (!addressed)
+			{
+				lcd_goto (line + 1, window * LCD_SCREEN_COLUMNS + col);
+				addressed = 1;
+			}
+
+			/* The address is auto-incremented for the next cell */
+			lcd_data (c);
+			ddram[window][line][col] = c;
+			sent++;
+		}
+	}
+
+	return sent;
+}
+
+/**
+ * lcd_screen_shift_to:
+ *
+ * @window: the window to be made visible
+ */
+static void lcd_screen_shift_to (uint8_t window)
+{
+	uint8_t step = 0;
+
+	if (window == visible_window)
+	{
+		return;
+	}
+
+	if (window == 0)
+	{
+		/* Undoes the shift without touching the DDRAM */
+		lcd_command (RETURN_HOME);
+	}
+	else
+	{
+		for (step = 0; step < LCD_SCREEN_COLUMNS; step++)
+		{
+			lcd_quick_command (SHIFT_DISPLAY_LEFT);
+		}
+	}
+
+	visible_window = window;
+}
+
+void lcd_screen_init (void)
+{
+	uint8_t page = 0, line = 0, col = 0, window = 0;
+
+	for (page = 0; page < LCD_SCREEN_PAGES; page++)
+	{
+		lcd_screen_clear (page);
+	}
+
+	/* The DDRAM of a cleared LCD is filled with spaces */
+	for (window = 0; window < WINDOWS; window++)
+	{
+		for (line = 0; line < LCD_SCREEN_LINES; line++)
+		{
+			for (col = 0; col < LCD_SCREEN_COLUMNS; col++)
+			{
+				ddram[window][line][col] = ' ';
+			}
+		}
+
+		window_page[window] = NO_PAGE;
+	}
+
+	window_page[0] = 0;
+	visible_window = 0;
+}
+
+void lcd_screen_write (uint8_t page, uint8_t line, uint8_t col,
+                       const char *buf, uint8_t len)
+{
+	if (page >= LCD_SCREEN_PAGES || line == 0 || line > LCD_SCREEN_LINES)
+	{
+		/* Do nothing if the request is for an invalid position */
+		return;
+	}
+
+	for (; len > 0 && col < LCD_SCREEN_COLUMNS; len--, col++)
+	{
+		pages[page][line - 1][col] = *buf++;
+	}
+}
+
+void lcd_screen_clear (uint8_t page)
+{
+	uint8_t line = 0, col = 0;
+
+	if (page >= LCD_SCREEN_PAGES)
+	{
+		return;
+	}
+
+	for (line = 0; line < LCD_SCREEN_LINES; line++)
+	{
+		for (col = 0; col < LCD_SCREEN_COLUMNS; col++)
+		{
+			pages[page][line][col] = ' ';
+		}
+	}
+}
+
+void lcd_screen_show (uint8_t page)
+{
+	uint8_t window = 0;
+
+	if (page >= LCD_SCREEN_PAGES)
+	{
+		return;
+	}
+
+	if (window_page[0] == page)
+	{
+		window = 0;
+	}
+	else if (window_page[1] == page)
+	{
+		window = 1;
+	}
+	else
+	{
+		/* Replace the page in the hidden window; the visible one stays */
+		window = !visible_window;
+		window_page[window] = page;
+	}
+
+	lcd_screen_sync (window);
+	lcd_screen_shift_to (window);
+}
+
+uint8_t lcd_screen_refresh (void)
+{
+	uint8_t sent = 0, window = 0;
+
+	for (window = 0; window < WINDOWS; window++)
+	{
+		sent += lcd_screen_sync (window);
+	}
+
+	return sent;
+}
+
+uint8_t lcd_screen_visible (void)
+{
+	return window_page[visible_window];
+}
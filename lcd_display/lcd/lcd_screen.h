@@ -0,0 +1,98 @@
+#ifndef KS_LCD_SCREEN_ATMEGA32
+#define KS_LCD_SCREEN_ATMEGA32
+
+/**
+ * Off-screen pages of the 2x16 display kept in the RAM.
+ *
+ * The applications write to their pages at any time, whether the page
+ * is visible or not. A copy of what the DDRAM of the LCD holds is kept
+ * so that only the cells that differ are sent when a page is shown or
+ * refreshed. A run of such cells is sent after setting the address once.
+ *
+ * Each line of the DDRAM has 40 columns of which 16 are visible. The
+ * first 32 columns are used as two windows (0 - 15 and 16 - 31) each
+ * holding a page. The two most recently shown pages are kept in the
+ * windows and the hidden one is updated on every refresh, so switching
+ * between them only needs the display to be shifted:
+ *
+ * 	- to window 0: a single return home command
+ *
+ * 	- to window 1: 16 display shift commands (~40us each)
+ *
+ * Any other page is first written to the hidden window (only the cells
+ * that differ from the page it replaces).
+ *
+ * Notes:
+ *
+ * 1. lcd_screen_init must be invoked on a freshly initialised (cleared)
+ *    LCD and nothing else must write to the DDRAM afterwards.
+ *
+ * 2. The display shift is also used by the marquee (lcd_marquee.h); the
+ *    two cannot be used together.
+ *
+ * Lines are numbered 1 and 2 as in lcd.h; columns 0 - 15.
+ */
+
+#include <stdint.h>
+#include "lcd.h"
+
+#define LCD_SCREEN_PAGES 4
+#define LCD_SCREEN_LINES 2
+#define LCD_SCREEN_COLUMNS 16
+
+/**
+ * lcd_screen_init:
+ *
+ * Fill all the pages with spaces and show page 0.
+ */
+void lcd_screen_init (void);
+
+/**
+ * lcd_screen_write:
+ *
+ * @page: the page (0 - LCD_SCREEN_PAGES - 1)
+ * @line_num: the line number (either 1 or 2)
+ * @col: the column of the first character
+ * @buf: the characters to be written (need not be NUL terminated)
+ * @len: number of characters; those past the end of the line are dropped
+ *
+ * Write the characters to the page. The LCD is not updated till the next
+ * lcd_screen_refresh or lcd_screen_show.
+ */
+void lcd_screen_write (uint8_t page, uint8_t line_num, uint8_t col,
+                       const char *buf, uint8_t len);
+
+/**
+ * lcd_screen_clear:
+ *
+ * @page: the page to be filled with spaces
+ */
+void lcd_screen_clear (uint8_t page);
+
+/**
+ * lcd_screen_show:
+ *
+ * @page: the page to be made visible
+ *
+ * Bring the page to the LCD and make it visible (see above).
+ */
+void lcd_screen_show (uint8_t page);
+
+/**
+ * lcd_screen_refresh:
+ *
+ * Send the cells of the pages held in the windows that changed since
+ * they were last sent.
+ *
+ * Returns: the number of cells sent.
+ */
+uint8_t lcd_screen_refresh (void);
+
+/**
+ * lcd_screen_visible:
+ *
+ * Returns: the page that is visible.
+ */
+uint8_t lcd_screen_visible (void);
+
+#endif
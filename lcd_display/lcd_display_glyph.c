@@ -0,0 +1,101 @@
+/**
+ * Program to test the cache of custom characters in the CGRAM.
+ *
+ * The first line shows a moving bar graph drawn with 8 bar glyphs (one
+ * per height) which fills all the CGRAM slots. Every few frames a heart
+ * or a bell is put at the end of the line, so a glyph shown on the screen
+ * has to be replaced (its cells fall back to a plain character) till the
+ * bars need it again.
+ *
+ * The second line shows the counters of the cache:
+ *
+ * 		hNNNNN mNNNN eNNN
+ *
+ * (hits, misses, evictions of glyphs shown on the screen).
+ *
+ * Port D - data pins to LCD
+ * Port A:
+ *
+ * 	Pin 0: Enable pin of LCD
+ * 	Pin 1: Read/Write pin of LCD
+ * 	Pin 2: RS pin of LCD
+ */
+
+#include "lcd/lcd.h"
+#include "lcd/lcd_glyph.h"
+#include "lcd/lcd_format.h"
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <util/delay.h>
+
+#define BARS 8
+#define GLYPH_HEART BARS
+#define GLYPH_BELL (BARS + 1)
+
+#define GRAPH_COLUMNS 15
+#define FRAME_MS 200
+#define SYMBOL_FRAMES 10
+
+static const struct lcd_glyph library[] PROGMEM = {
+	/* Bars of height 1 - 8 */
+	{ { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F }, '_' },
+	{ { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F }, '_' },
+	{ { 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F }, '_' },
+	{ { 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F }, '-' },
+	{ { 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F }, '-' },
+	{ { 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F }, '-' },
+	{ { 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F }, '=' },
+	{ { 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F }, '=' },
+
+	/* Heart */
+	{ { 0x00, 0x0A, 0x1F, 0x1F, 0x0E, 0x04, 0x00, 0x00 }, '<' },
+
+	/* Bell */
+	{ { 0x04, 0x0E, 0x0E, 0x0E, 0x1F, 0x00, 0x04, 0x00 }, '!' }
+};
+
+static void display_stats (void)
+{
+	const struct lcd_glyph_stats *const stats = lcd_glyph_get_stats ();
+	struct lcd_format fmt;
+
+	lcd_format_init (&fmt);
+	lcd_format_char (&fmt, 'h');
+	lcd_format_uint (&fmt, stats->hits, 5, '0');
+	lcd_format_P (&fmt, PSTR (" m"));
+	lcd_format_uint (&fmt, stats->misses, 4, '0');
+	lcd_format_P (&fmt, PSTR (" e"));
+	lcd_format_uint (&fmt, stats->evictions, 3, '0');
+	lcd_format_flush (&fmt, 2, 0);
+}
+
+int main(void)
+{
+	uint8_t frame = 0, col = 0;
+
+	DDRD = 0xFF;
+	DDRA |= 0x07;
+
+	initialize_lcd();
+	lcd_glyph_init (library, sizeof (library) / sizeof (library[0]));
+
+	while (1)
+	{
+		/* A bar per column; the heights form a wave moving left */
+		for (col = 0; col < GRAPH_COLUMNS; col++)
+		{
+			lcd_glyph_put (1, col, (uint8_t) (frame + col) % BARS);
+		}
+
+		if (frame % SYMBOL_FRAMES == 0)
+		{
+			lcd_glyph_put (1, GRAPH_COLUMNS,
+			               ((frame / SYMBOL_FRAMES) & 1) ? GLYPH_BELL : GLYPH_HEART);
+		}
+
+		display_stats ();
+
+		frame++;
+		_delay_ms (FRAME_MS);
+	}
+}
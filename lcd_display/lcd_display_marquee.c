@@ -0,0 +1,53 @@
+/**
+ * Program to test the marquee of text longer than the display.
+ *
+ * Both the lines are loaded with text longer than the 16 visible
+ * columns which is scrolled by the display shift every 300ms. The
+ * direction is reversed after a whole turn (40 steps) of the DDRAM.
+ *
+ * Port D - data pins to LCD
+ * Port A:
+ *
+ * 	Pin 0: Enable pin of LCD
+ * 	Pin 1: Read/Write pin of LCD
+ * 	Pin 2: RS pin of LCD
+ */
+
+#include "lcd/lcd.h"
+#include "lcd/lcd_marquee.h"
+#include "../scheduler/sched/sched.h"
+#include <avr/io.h>
+#include <string.h>
+
+#define STEP_MS 300u
+
+static uint8_t direction = LCD_MARQUEE_LEFT;
+
+static void reverse (void)
+{
+	direction = (direction == LCD_MARQUEE_LEFT) ? LCD_MARQUEE_RIGHT :
+	                                              LCD_MARQUEE_LEFT;
+
+	lcd_marquee_start (STEP_MS, direction);
+}
+
+int main(void)
+{
+	static const char line_1[] = "DS1307 RTC + HD44780 LCD on an ATMEGA32";
+	static const char line_2[] = "Scrolled by the display shift";
+
+	DDRD = 0xFF;
+	DDRA |= 0x07;
+
+	initialize_lcd();
+	SCHED_init ();
+
+	lcd_marquee_load (1, line_1, strlen (line_1));
+	lcd_marquee_load (2, line_2, strlen (line_2));
+
+	lcd_marquee_start (STEP_MS, direction);
+	SCHED_add (reverse, LCD_MARQUEE_COLUMNS * STEP_MS,
+	           LCD_MARQUEE_COLUMNS * STEP_MS, SCHED_PRIORITY_LOW);
+
+	SCHED_run ();
+}
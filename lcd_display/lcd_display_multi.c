@@ -0,0 +1,66 @@
+/**
+ * Program to test several LCDs sharing the data bus.
+ *
+ * All the displays are initialised at once and get the same title on
+ * the first line. The second line of each display shows its own number
+ * followed by a counter that is written to all of them at once.
+ *
+ * Port D - data pins shared by all the LCDs
+ * Port A:
+ *
+ * 	Pin 0: Enable pin of LCD 0
+ * 	Pin 1: Read/Write pin of all the LCDs
+ * 	Pin 2: RS pin of all the LCDs
+ * 	Pin 3: Enable pin of LCD 1
+ * 	Pin 4: Enable pin of LCD 2
+ * 	Pin 5: Enable pin of LCD 3
+ */
+
+#include "lcd/lcd.h"
+#include "lcd/lcd_multi.h"
+#include <avr/io.h>
+#include <util/delay.h>
+
+#define DISPLAYS 4
+
+static const uint8_t enable_pins[DISPLAYS] = {
+	LCD_EN_0, LCD_EN_1, LCD_EN_2, LCD_EN_3
+};
+
+int main(void)
+{
+	static const char title[] = "Shared data bus";
+	uint8_t display = 0;
+	uint8_t count = 0;
+
+	DDRD = 0xFF;
+	DDRA |= 0x3F;
+
+	initialize_lcd_multi (LCD_EN_ALL);
+
+	/* The same text to all the displays */
+	lcd_multi_goto (LCD_EN_ALL, 1, 0);
+	lcd_multi_write (LCD_EN_ALL, title, sizeof (title) - 1);
+
+	/* A different text to each display */
+	for (; display < DISPLAYS; display++)
+	{
+		const char label[] = { 'L', 'C', 'D', ' ', '0' + display };
+
+		lcd_multi_goto (enable_pins[display], 2, 0);
+		lcd_multi_write (enable_pins[display], label, sizeof (label));
+	}
+
+	while (1)
+	{
+		const char digits[3] = {
+			'0' + count / 100, '0' + (count / 10) % 10, '0' + count % 10
+		};
+
+		lcd_multi_goto (LCD_EN_ALL, 2, 13);
+		lcd_multi_write (LCD_EN_ALL, digits, sizeof (digits));
+
+		count++;
+		_delay_ms (500);
+	}
+}
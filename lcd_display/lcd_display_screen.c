@@ -0,0 +1,85 @@
+/**
+ * Program to test the off-screen pages of the LCD.
+ *
+ * Three pages are shown in turn for 2 seconds each. Page 0 holds a
+ * counter that is updated every 250ms whether the page is visible or
+ * not; the last line of page 2 shows the number of cells sent by the
+ * last refresh.
+ *
+ * Port D - data pins to LCD
+ * Port A:
+ *
+ * 	Pin 0: Enable pin of LCD
+ * 	Pin 1: Read/Write pin of LCD
+ * 	Pin 2: RS pin of LCD
+ */
+
+#include "lcd/lcd.h"
+#include "lcd/lcd_screen.h"
+#include <avr/io.h>
+#include <util/delay.h>
+
+#define SHOWN_PAGES 3
+#define UPDATE_MS 250
+#define UPDATES_PER_PAGE 8
+
+/**
+ * write_number:
+ *
+ * Write a number right aligned at the end of a line of a page.
+ */
+static void write_number (uint8_t page, uint8_t line_num, uint16_t value)
+{
+	char digits[5];
+	uint8_t index = sizeof (digits);
+
+	do
+	{
+		digits[--index] = '0' + (value % 10);
+		value /= 10;
+	} while (value > 0 && index > 0);
+
+	while (index > 0)
+	{
+		digits[--index] = ' ';
+	}
+
+	lcd_screen_write (page, line_num, LCD_SCREEN_COLUMNS - sizeof (digits),
+	                  digits, sizeof (digits));
+}
+
+int main(void)
+{
+	uint16_t count = 0;
+	uint8_t page = 0, update = 0, sent = 0;
+
+	DDRD = 0xFF;
+	DDRA |= 0x07;
+
+	initialize_lcd();
+	lcd_screen_init ();
+
+	lcd_screen_write (0, 1, 0, "Page 0: counter", 15);
+	lcd_screen_write (1, 1, 0, "Page 1: static", 14);
+	lcd_screen_write (1, 2, 0, "shown by a shift", 16);
+	lcd_screen_write (2, 1, 0, "Page 2: stats", 13);
+	lcd_screen_write (2, 2, 0, "cells sent", 10);
+
+	while (1)
+	{
+		lcd_screen_show (page);
+
+		for (update = 0; update < UPDATES_PER_PAGE; update++)
+		{
+			_delay_ms (UPDATE_MS);
+
+			/* The hidden pages are written just the same */
+			write_number (0, 2, ++count);
+			write_number (2, 2, sent);
+
+			sent = lcd_screen_refresh ();
+		}
+
+		page = (page + 1) % SHOWN_PAGES;
+	}
+}
@@ -11,15 +11,47 @@
  */
 
 #include "../lcd/lcd.h"
+#include "../lcd/lcd_format.h"
 #include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <util/delay.h>
 #include <string.h>
 
 void write_data (const char *const data)
 {
-	for (uint16_t curr_char=0; curr_char < strlen (data); curr_char++)
-	{
-		lcd_data (*(data+curr_char));
-	}
+	/* The length is found only once and not for every character */
+	const size_t len = strlen (data);
+
+	/* lcd_write takes at most 255 characters; the DDRAM holds fewer */
+	lcd_write (data, (len > UINT8_MAX) ? UINT8_MAX : len);
+}
+
+/**
+ * write_formatted:
+ *
+ * Exercise every conversion of the formatter:
+ *
+ * 	01234  -56 59
+ * 	 -23.45 0.005 P
+ */
+void write_formatted (void)
+{
+	struct lcd_format fmt;
+
+	lcd_format_init (&fmt);
+	lcd_format_uint (&fmt, 1234, 5, '0');
+	lcd_format_char (&fmt, ' ');
+	lcd_format_int (&fmt, -56, 4);
+	lcd_format_char (&fmt, ' ');
+	lcd_format_bcd (&fmt, 0x59);
+	lcd_format_flush (&fmt, 1, 0);
+
+	lcd_format_init (&fmt);
+	lcd_format_fixed (&fmt, -2345, 2, 7);
+	lcd_format_char (&fmt, ' ');
+	lcd_format_fixed (&fmt, 5, 3, 5);
+	lcd_format_P (&fmt, PSTR (" P"));
+	lcd_format_flush (&fmt, 2, 0);
 }
 
 int main(void)
@@ -46,4 +78,11 @@ int main(void)
 
 	// Check what happens when we try to shift the display
 	lcd_command (0x14);
+
+	_delay_ms (2000);
+
+	/* Clear the display (also undoes the shift) */
+	lcd_command (0x01);
+
+	write_formatted ();
 }
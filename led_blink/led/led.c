@@ -0,0 +1,105 @@
+#include <avr/interrupt.h>
+#include "led.h"
+
+/*
+ * Timer0 for the blink: 1MHz / 1024 (prescaler) => 1.024ms per count
+ */
+#define BLINK_PRESCALER_BITS ((1<<CS02) | (1<<CS00))
+
+/*
+ * Timer1 for BAM: 1MHz / 8 (prescaler) => 8 counts (64us) per unit
+ */
+#define BAM_PRESCALER_BITS (1<<CS11)
+#define BAM_UNIT_COUNTS 8u
+
+#define BAM_BITS 8
+
+/* Value of the port for every bit of the brightness */
+static volatile uint8_t planes[BAM_BITS];
+
+/* The bit whose period is in progress */
+static uint8_t curr_bit = 0;
+
+int8_t
+LED_blink_start (uint16_t half_period)
+{
+	/* Number of counts = half_period * 1000 / 1024 */
+	const uint16_t counts = (half_period * 125u) / 128u;
+
+	if (half_period == 0 || half_period > LED_BLINK_MAX_MS || counts == 0)
+	{
+		return 1;
+	}
+
+	DDRB |= (1<<PB3);
+
+	/* CTC mode, toggle OC0 on compare match */
+	TCCR0 = 0;
+	TCNT0 = 0;
+	OCR0 = counts - 1;
+	TCCR0 = (1<<WGM01) | (1<<COM00) | BLINK_PRESCALER_BITS;
+
+	return 0;
+}
+
+void
+LED_blink_stop (void)
+{
+	TCCR0 = 0;
+}
+
+void
+LED_bam_start (void)
+{
+	uint8_t bit = 0;
+
+	for (; bit < BAM_BITS; bit++)
+	{
+		planes[bit] = 0;
+	}
+
+	DDRB = 0xFF;
+	curr_bit = 0;
+
+	/* CTC mode with OCR1A as TOP */
+	TCCR1A = 0;
+	TCCR1B = 0;
+	TCNT1 = 0;
+	OCR1A = BAM_UNIT_COUNTS - 1;
+	TIMSK |= (1<<OCIE1A);
+	TCCR1B = (1<<WGM12) | BAM_PRESCALER_BITS;
+}
+
+void
+LED_bam_stop (void)
+{
+	TCCR1B = 0;
+	TIMSK &= ~(1<<OCIE1A);
+}
+
+void
+LED_set_brightness (uint8_t channel, uint8_t brightness)
+{
+	const uint8_t pin = (1 << (channel & 7));
+	uint8_t bit = 0;
+
+	for (; bit < BAM_BITS; bit++, brightness >>= 1)
+	{
+		/* Each plane is a single byte so its update is atomic */
+		planes[bit] = (brightness & 1) ? (planes[bit] | pin) :
+		                                 (planes[bit] & ~pin);
+	}
+}
+
+/**
+ * Start the period of the next bit: show its plane and set the length
+ * of the period to 2^bit units. The counter has just been cleared by
+ * the compare match so OCR1A could be changed safely.
+ */
+ISR (TIMER1_COMPA_vect)
+{
+	curr_bit = (curr_bit + 1) & (BAM_BITS - 1);
+
+	PORTB = planes[curr_bit];
+	OCR1A = (BAM_UNIT_COUNTS << curr_bit) - 1;
+}
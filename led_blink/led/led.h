@@ -0,0 +1,95 @@
+#ifndef KS_LED_ATMEGA32
+#define KS_LED_ATMEGA32
+
+/**
+ * Timer driven control of the LEDs on PORTB for the ATMEGA32 running
+ * at 1MHz.
+ *
+ * Blink:
+ *
+ * 	The LED on PB3 (OC0) is blinked by Timer0 toggling the pin in
+ * 	hardware on every compare match. No code runs once the blink is
+ * 	started. OC0 is the only output compare pin on PORTB so only this
+ * 	LED could be blinked this way. The half period is limited to 262ms
+ * 	by the 8-bit timer.
+ *
+ * Brightness:
+ *
+ * 	All eight LEDs have an 8-bit brightness using bit angle modulation
+ * 	(BAM) driven by Timer1. A frame has one period per bit of the
+ * 	brightness, bit n lasting 2^n units, and the whole port is written
+ * 	once at the start of every period. So a frame takes 8 interrupts
+ * 	for all the channels together instead of 256 steps of a software
+ * 	PWM.
+ *
+ * 	One unit is 64us so a frame takes ~16.3ms (~61Hz).
+ *
+ * Notes:
+ *
+ * 1. The blink uses Timer0 and hence cannot be used along with the
+ *    scheduler (scheduler/sched/sched.h).
+ *
+ * 2. While the blink is running, PB3 is driven by the timer and its
+ *    brightness channel has no effect.
+ *
+ * 3. Global interrupts have to be enabled for the brightness control.
+ */
+
+#include <stdint.h>
+#include <avr/io.h>
+
+#define LED_CHANNELS 8
+
+/* Longest half period of the blink */
+#define LED_BLINK_MAX_MS 262u
+
+/**
+ * LED_blink_start:
+ *
+ * @half_period: time in ms for which the LED is on (and off)
+ *               (1 - LED_BLINK_MAX_MS)
+ *
+ * Start blinking the LED on PB3.
+ *
+ * Returns: 0 on success. Non-zero value if the half period is out of range.
+ */
+int8_t
+LED_blink_start (uint16_t half_period);
+
+/**
+ * LED_blink_stop:
+ *
+ * Stop blinking and return PB3 to the control of PORTB.
+ */
+void
+LED_blink_stop (void);
+
+/**
+ * LED_bam_start:
+ *
+ * Configure PORTB for output and start the brightness control with all
+ * the channels off.
+ */
+void
+LED_bam_start (void);
+
+/**
+ * LED_bam_stop:
+ *
+ * Stop the brightness control. The port retains its last value.
+ */
+void
+LED_bam_stop (void);
+
+/**
+ * LED_set_brightness:
+ *
+ * @channel: the pin of PORTB (0 - 7)
+ * @brightness: 0 (off) - 255 (fully on)
+ *
+ * Set the brightness of a channel. Takes effect from the next period.
+ */
+void
+LED_set_brightness (uint8_t channel, uint8_t brightness);
+
+#endif
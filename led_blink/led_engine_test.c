@@ -0,0 +1,42 @@
+/**
+ * Fades the LEDs on Port B using the timer driven LED engine while the
+ * LED on PB3 blinks in hardware.
+ *
+ * Input: None
+ * Output: All pins of Port B
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/**
+ * The clock frequency of the default clock source (internal RC oscillator)
+ * for the ATMEGA32 controller is 1MHz.
+ */
+#define F_CPU 1000000UL
+
+#include <util/delay.h>
+#include "led/led.h"
+
+int main (void)
+{
+	uint8_t level = 0;
+
+	LED_bam_start ();
+	LED_blink_start (250u);
+	sei ();
+
+	while (1)
+	{
+		uint8_t channel = 0;
+
+		/* Each channel is a step brighter than the previous one */
+		for (; channel < LED_CHANNELS; channel++)
+		{
+			LED_set_brightness (channel, level + channel * 32u);
+		}
+
+		level++;
+		_delay_ms (10u);
+	}
+}
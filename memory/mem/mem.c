@@ -0,0 +1,72 @@
+#include "mem.h"
+
+/* Symbols defined by the linker script */
+extern uint8_t __data_start, __data_end;
+extern uint8_t __bss_start, __bss_end;
+extern uint8_t _end, __stack;
+
+void
+MEM_paint (void) __attribute__ ((naked, used, section (".init1")));
+
+/**
+ * MEM_paint:
+ *
+ * Fill the SRAM from the end of .bss to the top of the stack with the
+ * canary. Runs from .init1, before the stack pointer and the zero
+ * register are set up, so it is written in assembly and uses only the
+ * registers that the startup code initialises later.
+ */
+void
+MEM_paint (void)
+{
+	__asm__ __volatile__ (
+		"	ldi r30, lo8(_end)"     "\n\t"
+		"	ldi r31, hi8(_end)"     "\n\t"
+		"	ldi r24, %0"            "\n\t"
+		"	ldi r25, hi8(__stack)"  "\n\t"
+		"	rjmp 2f"                "\n\t"
+		"1:	st Z+, r24"             "\n\t"
+		"2:	cpi r30, lo8(__stack)"  "\n\t"
+		"	cpc r31, r25"           "\n\t"
+		"	brlo 1b"                "\n\t"
+		"	breq 1b"                "\n\t"
+		:
+		: "M" (MEM_CANARY)
+	);
+}
+
+/**
+ * MEM_lowest_stack_byte:
+ *
+ * Returns: the lowest address whose canary has been overwritten (by
+ *          the stack).
+ */
+static uint8_t *
+MEM_lowest_stack_byte (void)
+{
+	uint8_t *curr = &_end;
+
+	while (curr <= &__stack && *curr == MEM_CANARY)
+	{
+		curr++;
+	}
+
+	return curr;
+}
+
+uint16_t
+MEM_stack_high_water (void)
+{
+	return &__stack - MEM_lowest_stack_byte () + 1;
+}
+
+void
+MEM_get_usage (struct MEM_usage *usage)
+{
+	uint8_t *const lowest = MEM_lowest_stack_byte ();
+
+	usage->data_size = &__data_end - &__data_start;
+	usage->bss_size = &__bss_end - &__bss_start;
+	usage->stack_high_water = &__stack - lowest + 1;
+	usage->headroom = lowest - &_end;
+}
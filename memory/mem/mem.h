@@ -0,0 +1,72 @@
+#ifndef KS_MEM_ATMEGA32
+#define KS_MEM_ATMEGA32
+
+/**
+ * Instrumentation of the usage of the SRAM of the ATMEGA32.
+ *
+ * At reset, before the .data and .bss sections are initialised, the
+ * free SRAM between the end of the static data (.bss) and the top of the
+ * stack is filled with a canary pattern (by a function placed in the
+ * .init1 section; linking mem.c is enough to enable it). The stack grows
+ * down into this area overwriting the pattern. The lowest address whose
+ * canary has been overwritten gives the deepest point reached by the
+ * stack since the reset.
+ *
+ * Layout of the SRAM:
+ *
+ * 	RAMSTART: .data, .bss
+ * 	          ... free (canary) ...
+ * 	          stack (grows down)
+ * 	RAMEND
+ *
+ * Notes:
+ *
+ * 1. The usage by the heap (malloc) is not accounted for; nothing in
+ *    the project uses it.
+ *
+ * 2. The sizes of the static sections could also be checked at link
+ *    time using avr-size (e.g. the 'size' target of i2c_rtc/Makefile).
+ */
+
+#include <stdint.h>
+#include <avr/io.h>
+
+#define MEM_CANARY 0xC5u
+
+/**
+ * MEM_usage:
+ *
+ * Usage of the SRAM in bytes.
+ */
+struct MEM_usage
+{
+	uint16_t data_size;
+	uint16_t bss_size;
+
+	/* Most bytes of the stack used at any time since the reset */
+	uint16_t stack_high_water;
+
+	/* Bytes never touched by the stack since the reset */
+	uint16_t headroom;
+};
+
+/**
+ * MEM_get_usage:
+ *
+ * @usage: used to return the usage
+ *
+ * Compute the usage of the SRAM by scanning the canary pattern. Takes
+ * time proportional to the headroom (a few cycles per byte).
+ */
+void
+MEM_get_usage (struct MEM_usage *usage);
+
+/**
+ * MEM_stack_high_water:
+ *
+ * Returns: most bytes of the stack used at any time since the reset.
+ */
+uint16_t
+MEM_stack_high_water (void);
+
+#endif
@@ -0,0 +1,190 @@
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <util/atomic.h>
+#include "power.h"
+#include "../sched/sched.h"
+
+static uint8_t selected_mode = SLEEP_MODE_IDLE;
+
+/* Set by POWER_notify; cleared when the main line sees it */
+static volatile _Bool event_pending = 0;
+
+/* Whether the main line is (about to be) asleep */
+static volatile _Bool asleep = 0;
+
+/* Fine tick at which the interrupt that woke up the MCU notified */
+static volatile uint16_t notify_stamp = 0;
+static volatile _Bool notify_stamped = 0;
+
+static struct POWER_stats stats;
+
+/* Time asleep in fine ticks and the total time in ticks */
+static uint32_t asleep_fine_ticks = 0;
+static uint32_t total_ticks = 0;
+
+/*
+ * Both the counts are halved whenever the total passes this so that the
+ * percentage is that of the recent past and the counts stay bounded:
+ * the total stays below 60000 + 65535 ticks (the most that could be
+ * added at once) and the time asleep below 125 times that, so even
+ * 100 times the time asleep fits in 32 bits.
+ */
+#define STATS_WINDOW_TICKS 60000u
+static uint16_t last_tick = 0;
+
+void
+POWER_set_mode (uint8_t mode)
+{
+	selected_mode = (mode == POWER_MODE_POWER_SAVE) ? SLEEP_MODE_PWR_SAVE
+	                                             : SLEEP_MODE_IDLE;
+}
+
+void
+POWER_init (uint8_t mode)
+{
+	POWER_set_mode (mode);
+	POWER_reset_stats ();
+}
+
+void
+POWER_reset_stats (void)
+{
+	stats.wakes = 0;
+	stats.latency_last = 0;
+	stats.latency_min = UINT16_MAX;
+	stats.latency_max = 0;
+	stats.asleep_percent = 0;
+
+	asleep_fine_ticks = 0;
+	total_ticks = 0;
+	last_tick = SCHED_ticks ();
+}
+
+void
+POWER_notify (void)
+{
+	event_pending = 1;
+
+	if (asleep && !notify_stamped)
+	{
+		notify_stamp = SCHED_fine_ticks ();
+		notify_stamped = 1;
+	}
+}
+
+/**
+ * POWER_account_wake:
+ *
+ * @slept: time asleep in fine ticks
+ *
+ * Update the statistics after a wake-up.
+ */
+static void
+POWER_account_wake (uint16_t slept)
+{
+	const uint16_t resumed = SCHED_fine_ticks ();
+
+	stats.wakes++;
+	asleep_fine_ticks += slept;
+
+	if (notify_stamped)
+	{
+		const uint16_t latency = resumed - notify_stamp;
+
+		stats.latency_last = latency;
+
+		if (latency < stats.latency_min)
+		{
+			stats.latency_min = latency;
+		}
+
+		if (latency > stats.latency_max)
+		{
+			stats.latency_max = latency;
+		}
+
+		notify_stamped = 0;
+	}
+}
+
+/**
+ * POWER_account_time:
+ *
+ * Add the ticks since the last invocation to the total time. Invoked on
+ * every idle so that the 16-bit difference does not wrap around.
+ */
+static void
+POWER_account_time (void)
+{
+	const uint16_t now = SCHED_ticks ();
+
+	total_ticks += (uint16_t) (now - last_tick);
+	last_tick = now;
+
+	while (total_ticks > STATS_WINDOW_TICKS)
+	{
+		total_ticks >>= 1;
+		asleep_fine_ticks >>= 1;
+	}
+}
+
+void
+POWER_idle (void)
+{
+	uint16_t start = 0;
+
+	POWER_account_time ();
+
+	/*
+	 * Interrupts are disabled between checking for the events and going
+	 * to sleep so that an event in between is not left waiting for the
+	 * next interrupt. The instruction following sei is always executed
+	 * before any pending interrupt is serviced.
+	 */
+	cli ();
+
+	if (event_pending)
+	{
+		event_pending = 0;
+		sei ();
+		return;
+	}
+
+	asleep = 1;
+	start = SCHED_fine_ticks ();
+
+	set_sleep_mode (selected_mode);
+	sleep_enable ();
+	sei ();
+	sleep_cpu ();
+	sleep_disable ();
+
+	/* The interrupt that woke up the MCU has been serviced by now */
+	asleep = 0;
+
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		POWER_account_wake (SCHED_fine_ticks () - start);
+		event_pending = 0;
+	}
+}
+
+void
+POWER_get_stats (struct POWER_stats *out)
+{
+	POWER_account_time ();
+
+	/* Fine ticks asleep against the ticks in all; bounded as noted above */
+	if (total_ticks > 0)
+	{
+		const uint32_t percent = (asleep_fine_ticks * 100) /
+		                         (total_ticks * SCHED_FINE_TICKS_PER_MS);
+
+		stats.asleep_percent = (percent > 100) ? 100 : percent;
+	}
+
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		*out = stats;
+	}
+}
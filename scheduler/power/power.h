@@ -0,0 +1,127 @@
+#ifndef KS_POWER_ATMEGA32
+#define KS_POWER_ATMEGA32
+
+/**
+ * Puts the MCU to sleep when the scheduler has nothing to run.
+ *
+ * POWER_idle is meant to be the idle hook of the scheduler (see
+ * SCHED_set_idle_hook). Any enabled interrupt wakes up the MCU: the tick
+ * of the scheduler, the square wave of the RTC on INT2, the reception of
+ * the UART, a change of the inputs and so on. The scheduler then looks
+ * up the due tasks again.
+ *
+ * Events:
+ *
+ * 	An interrupt that leaves work for the main line (rather than
+ * 	making a task due on a tick) should invoke POWER_notify. The MCU is
+ * 	then not put to sleep if the event happened just before the sleep
+ * 	and the latency of the wake-up is recorded.
+ *
+ * Modes:
+ *
+ * 	POWER_MODE_IDLE - only the CPU is stopped. The timers keep running
+ * 	                  so the scheduler keeps ticking.
+ *
+ * 	POWER_MODE_POWER_SAVE - all the clocks but that of an asynchronous
+ * 	                  Timer2 are stopped. Timer0 (and so the tick of
+ * 	                  the scheduler) stops as well; only the external
+ * 	                  interrupts (INT0/1/2 level or INT2 edge), TWI and
+ * 	                  Timer2 could wake up the MCU. Meant for the
+ * 	                  applications driven entirely by such events.
+ *
+ * Statistics:
+ *
+ * 	The time asleep is measured in fine ticks (8us) of the scheduler
+ * 	and the total time in ticks (1ms). Since the timers don't run in
+ * 	the Power-save mode only the number of wake-ups is meaningful
+ * 	in that mode.
+ */
+
+#include <stdint.h>
+
+#define POWER_MODE_IDLE 0u
+#define POWER_MODE_POWER_SAVE 1u
+
+/**
+ * POWER_stats:
+ *
+ * Statistics of the sleeps since the last POWER_reset_stats.
+ */
+struct POWER_stats
+{
+	uint16_t wakes;
+
+	/*
+	 * Time from POWER_notify (in an interrupt) till the main line
+	 * resumed, in fine ticks (8us). Only the wake-ups caused by such
+	 * an interrupt are accounted.
+	 */
+	uint16_t latency_last;
+	uint16_t latency_min;
+	uint16_t latency_max;
+
+	/*
+	 * Percentage of time the MCU was asleep over the recent past (the
+	 * counts are halved every ~1 minute so older sleeps weigh less)
+	 */
+	uint8_t asleep_percent;
+};
+
+/**
+ * POWER_init:
+ *
+ * @mode: the sleep mode to be used (POWER_MODE_*)
+ *
+ * Select the sleep mode and reset the statistics.
+ *
+ * Note: SCHED_init must have been invoked before.
+ */
+void
+POWER_init (uint8_t mode);
+
+/**
+ * POWER_set_mode:
+ *
+ * @mode: the sleep mode to be used for the next sleeps (POWER_MODE_*)
+ */
+void
+POWER_set_mode (uint8_t mode);
+
+/**
+ * POWER_idle:
+ *
+ * Sleep till an interrupt unless an event has been notified since the
+ * last invocation. To be used as the idle hook of the scheduler.
+ */
+void
+POWER_idle (void);
+
+/**
+ * POWER_notify:
+ *
+ * Notify that an event has to be handled by the main line. To be invoked
+ * from the interrupts, preferably as early as possible so that the
+ * latency measured includes the handling of the interrupt. Does nothing
+ * but set a flag if POWER_idle is not in use, so the drivers invoke it
+ * unconditionally (see input.h, capture.h and clock.h).
+ */
+void
+POWER_notify (void);
+
+/**
+ * POWER_get_stats:
+ *
+ * @stats: used to return the statistics
+ */
+void
+POWER_get_stats (struct POWER_stats *stats);
+
+/**
+ * POWER_reset_stats:
+ *
+ * Start the statistics afresh.
+ */
+void
+POWER_reset_stats (void);
+
+#endif
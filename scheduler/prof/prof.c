@@ -0,0 +1,174 @@
+#include <util/atomic.h>
+#include "prof.h"
+
+#ifdef SCHED_XTAL_TICK
+/* Timer1 is already run freely by the scheduler (1MHz / 8) */
+#define PROF_CYCLES_PER_COUNT 8u
+#else
+#define PROF_CYCLES_PER_COUNT 1u
+#endif
+
+static struct PROF_entry entries[PROF_MAX_ENTRIES];
+
+/* Iterations of the idle loop in the current slot */
+static uint16_t idle_count = 0;
+
+/* Iterations of the idle loop in each slot of the window */
+static uint16_t window[PROF_WINDOW_SLOTS];
+static uint8_t window_index = 0;
+
+/* Number of slots of the window filled since the calibration */
+static uint8_t window_filled = 0;
+
+static uint16_t baseline = 0;
+
+/*
+ * 2: the current (partial) slot is to be skipped
+ * 1: the next complete slot is to be taken as the baseline
+ * 0: calibrated
+ */
+static uint8_t calibrating = 0;
+
+/**
+ * PROF_sample:
+ *
+ * Periodic task that moves the count of the idle loop to the window.
+ */
+static void
+PROF_sample (void)
+{
+	const uint16_t count = idle_count;
+
+	idle_count = 0;
+
+	if (calibrating)
+	{
+		if (--calibrating == 0)
+		{
+			baseline = count;
+			window_filled = 0;
+		}
+
+		return;
+	}
+
+	if (count > baseline)
+	{
+		baseline = count;
+	}
+
+	window[window_index] = count;
+	window_index = (window_index + 1) % PROF_WINDOW_SLOTS;
+
+	if (window_filled < PROF_WINDOW_SLOTS)
+	{
+		window_filled++;
+	}
+}
+
+int8_t
+PROF_init (void)
+{
+	uint8_t slot = 0;
+
+#ifndef SCHED_XTAL_TICK
+	/* Normal mode, no prescaling */
+	TCCR1A = 0;
+	TCCR1B = (1<<CS10);
+#endif
+
+	for (slot = 0; slot < PROF_WINDOW_SLOTS; slot++)
+	{
+		window[slot] = 0;
+	}
+
+	PROF_reset ();
+	PROF_calibrate ();
+
+	return SCHED_add (PROF_sample, PROF_SLOT_MS, PROF_SLOT_MS,
+	                  SCHED_PRIORITY_HIGH) < 0;
+}
+
+void
+PROF_calibrate (void)
+{
+	calibrating = 2;
+}
+
+void
+PROF_idle (void)
+{
+	idle_count++;
+}
+
+void
+PROF_end (uint8_t entry, uint16_t start)
+{
+	struct PROF_entry *const e = &entries[entry];
+	uint32_t cycles = (uint16_t) (PROF_begin () - start);
+
+	cycles *= PROF_CYCLES_PER_COUNT;
+
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		e->runs++;
+		e->total += cycles;
+
+		if (cycles < e->min)
+		{
+			e->min = cycles;
+		}
+
+		if (cycles > e->max)
+		{
+			/* Saturates with a Timer1 of 8 cycles per count */
+			e->max = (cycles > UINT16_MAX) ? UINT16_MAX : cycles;
+		}
+	}
+}
+
+void
+PROF_get_entry (uint8_t entry, struct PROF_entry *out)
+{
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		*out = entries[entry];
+	}
+}
+
+uint8_t
+PROF_load (void)
+{
+	uint32_t idle = 0;
+	uint8_t slot = 0;
+
+	if (baseline == 0 || window_filled == 0)
+	{
+		return 0;
+	}
+
+	/* The slots not yet filled are the ones after the current index */
+	for (slot = 0; slot < window_filled; slot++)
+	{
+		idle += window[(window_index + PROF_WINDOW_SLOTS - 1 - slot) % PROF_WINDOW_SLOTS];
+	}
+
+	return 100 - (uint8_t) ((idle * 100) / ((uint32_t) baseline * window_filled));
+}
+
+void
+PROF_reset (void)
+{
+	uint8_t entry = 0;
+
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		for (entry = 0; entry < PROF_MAX_ENTRIES; entry++)
+		{
+			entries[entry].runs = 0;
+			entries[entry].min = UINT16_MAX;
+			entries[entry].max = 0;
+			entries[entry].total = 0;
+		}
+	}
+}
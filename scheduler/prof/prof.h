@@ -0,0 +1,167 @@
+#ifndef KS_PROF_ATMEGA32
+#define KS_PROF_ATMEGA32
+
+/**
+ * Measures how busy the CPU is and how long the tasks and interrupts run.
+ *
+ * Load:
+ *
+ * 	PROF_idle is meant to be the idle hook of the scheduler (or to be
+ * 	invoked from it). It counts the iterations of the idle loop which
+ * 	are sampled every PROF_SLOT_MS into a moving window of
+ * 	PROF_WINDOW_SLOTS slots. The load is the fraction of the
+ * 	iterations missing against the baseline: the count of an
+ * 	entirely idle slot.
+ *
+ * 	The baseline is the count of the next complete slot after
+ * 	PROF_calibrate, which has to be idle: PROF_init arms it so the
+ * 	other tasks should be added with a delay of 2 * PROF_SLOT_MS. The
+ * 	baseline is also raised whenever a slot is found to be more idle
+ * 	than it.
+ *
+ * Execution time:
+ *
+ * 	Timer1 runs freely from the CPU clock and the cycles between
+ * 	PROF_begin and PROF_end are accounted to an entry. Building the
+ * 	scheduler with SCHED_PROFILE defined accounts every task run to
+ * 	the entry PROF_ENTRY_TASK (id). Interrupts have to be instrumented
+ * 	by hand:
+ *
+ * 		ISR (INT0_vect)
+ * 		{
+ * 			const uint16_t start = PROF_begin ();
+ *
+ * 			...
+ *
+ * 			PROF_end (PROF_ENTRY_ISR (0), start);
+ * 		}
+ *
+ * Notes:
+ *
+ * 1. Timer1 must not be used by anything else. With SCHED_XTAL_TICK the
+ *    free running Timer1 of the scheduler is used as is (8 cycles per
+ *    count).
+ *
+ * 2. The time of a task includes that of the interrupts serviced while
+ *    it ran. Runs longer than 65535 counts of Timer1 are not measured
+ *    correctly.
+ *
+ * 3. The idle loop hardly iterates while the MCU sleeps so the load
+ *    could not be measured together with the POWER_idle hook.
+ */
+
+#include <stdint.h>
+#include <avr/io.h>
+#include <util/atomic.h>
+#include "../sched/sched.h"
+
+#define PROF_SLOT_MS 125u
+#define PROF_WINDOW_SLOTS 8u
+
+#define PROF_MAX_ISRS 4u
+#define PROF_MAX_ENTRIES (SCHED_MAX_TASKS + PROF_MAX_ISRS)
+
+#define PROF_ENTRY_TASK(id) ((uint8_t) (id))
+#define PROF_ENTRY_ISR(n) ((uint8_t) (SCHED_MAX_TASKS + (n)))
+
+/**
+ * PROF_entry:
+ *
+ * Execution times (in CPU cycles) accounted to an entry.
+ */
+struct PROF_entry
+{
+	uint16_t runs;
+	uint16_t min;
+	uint16_t max;
+	uint32_t total;
+};
+
+/**
+ * PROF_init:
+ *
+ * Start Timer1, clear the entries and add the task that samples the
+ * idle loop.
+ *
+ * Note: SCHED_init must have been invoked before.
+ *
+ * Returns: 0 on success. Non-zero value if the task could not be added.
+ */
+int8_t
+PROF_init (void);
+
+/**
+ * PROF_calibrate:
+ *
+ * Take the count of iterations of the next complete slot as the
+ * baseline. No task other than the sampling task should run during it.
+ */
+void
+PROF_calibrate (void);
+
+/**
+ * PROF_idle:
+ *
+ * Count an iteration of the idle loop. To be used as (or invoked from)
+ * the idle hook of the scheduler.
+ */
+void
+PROF_idle (void);
+
+/**
+ * PROF_begin:
+ *
+ * Returns: the current count of Timer1 to be passed to PROF_end.
+ */
+static inline uint16_t
+PROF_begin (void)
+{
+	uint16_t count = 0;
+
+	/* An interrupt reading Timer1 in between would corrupt the high byte */
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		count = TCNT1;
+	}
+
+	return count;
+}
+
+/**
+ * PROF_end:
+ *
+ * @entry: the entry to account the time to (PROF_ENTRY_*)
+ * @start: the value returned by PROF_begin
+ *
+ * Account the cycles since @start to @entry.
+ */
+void
+PROF_end (uint8_t entry, uint16_t start);
+
+/**
+ * PROF_get_entry:
+ *
+ * @entry: the entry (PROF_ENTRY_*)
+ * @out: used to return the execution times accounted to @entry
+ */
+void
+PROF_get_entry (uint8_t entry, struct PROF_entry *out);
+
+/**
+ * PROF_load:
+ *
+ * Returns: the percentage of time the CPU was busy over the last
+ *          PROF_WINDOW_SLOTS * PROF_SLOT_MS ms.
+ */
+uint8_t
+PROF_load (void);
+
+/**
+ * PROF_reset:
+ *
+ * Clear the execution times of all the entries.
+ */
+void
+PROF_reset (void);
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef KS_PT
+#define KS_PT
+
+/**
+ * Minimal stackless coroutines (protothreads) for writing resumable
+ * state machines as straight line code.
+ *
+ * A coroutine is a function that is invoked repeatedly (e.g. from a
+ * scheduler task) till it returns PT_DONE or PT_ERROR. Its position is
+ * kept in a 16-bit "local continuation" (lc) that has to be initialised
+ * using PT_INIT before the first invocation.
+ *
+ * Notes:
+ *
+ * 1. Local variables are not preserved across a PT_YIELD/PT_WAIT_UNTIL.
+ *    Anything that must survive has to be kept in the state structure of
+ *    the coroutine.
+ *
+ * 2. As the macros are built on a switch statement, a switch statement
+ *    must not be used between PT_BEGIN and PT_END.
+ *
+ * 3. A coroutine that returns PT_DONE or PT_ERROR starts again from
+ *    PT_BEGIN when it is invoked next.
+ */
+
+#include <stdint.h>
+
+/* Values returned by a coroutine */
+#define PT_WAITING 0
+#define PT_DONE 1
+#define PT_ERROR 2
+
+#define PT_INIT(lc) ((lc) = 0)
+
+#define PT_BEGIN(lc) switch (lc) { case 0:
+
+/**
+ * PT_WAIT_UNTIL:
+ *
+ * Return PT_WAITING till the condition is true. The condition is
+ * evaluated again every time the coroutine is invoked.
+ */
+#define PT_WAIT_UNTIL(lc, cond)       \
+	do {                          \
+		(lc) = __LINE__;      \
+		/* FALLTHROUGH */     \
+		case __LINE__:        \
+		if (!(cond))          \
+		{                     \
+			return PT_WAITING; \
+		}                     \
+	} while (0)
+
+/**
+ * PT_YIELD:
+ *
+ * Return PT_WAITING once and continue from here on the next invocation.
+ */
+#define PT_YIELD(lc)                  \
+	do {                          \
+		(lc) = __LINE__;      \
+		return PT_WAITING;    \
+		case __LINE__:;       \
+	} while (0)
+
+/**
+ * PT_EXIT:
+ *
+ * End the coroutine with the given status (PT_DONE or PT_ERROR).
+ */
+#define PT_EXIT(lc, status)           \
+	do {                          \
+		(lc) = 0;             \
+		return (status);      \
+	} while (0)
+
+#define PT_END(lc) } (lc) = 0; return PT_DONE
+
+#endif
@@ -0,0 +1,95 @@
+#include <stddef.h>
+#include "ring.h"
+
+uint8_t
+RING_write_span (struct RING_buffer *ring, uint8_t **span)
+{
+	const uint8_t index = ring->head & ring->mask;
+	const uint8_t to_end = ring->mask + 1 - index;
+	const uint8_t free = RING_free (ring);
+
+	*span = &ring->data[index];
+
+	return (free < to_end) ? free : to_end;
+}
+
+void
+RING_commit (struct RING_buffer *ring, uint8_t len)
+{
+	RING_BARRIER ();
+	ring->head = ring->head + len;
+}
+
+uint8_t
+RING_read_span (struct RING_buffer *ring, const uint8_t **span)
+{
+	const uint8_t index = ring->tail & ring->mask;
+	const uint8_t to_end = ring->mask + 1 - index;
+	const uint8_t count = RING_count (ring);
+
+	*span = &ring->data[index];
+
+	return (count < to_end) ? count : to_end;
+}
+
+void
+RING_consume (struct RING_buffer *ring, uint8_t len)
+{
+	RING_BARRIER ();
+	ring->tail = ring->tail + len;
+}
+
+int8_t
+RING_push_span (struct RING_buffer *ring, const uint8_t *src, uint8_t len)
+{
+	const uint8_t head = ring->head;
+	uint8_t pos = 0;
+
+	if (RING_free (ring) < len)
+	{
+		return 1;
+	}
+
+	/* Copy the bytes, wrapping as required, before publishing any of them */
+	for (; pos < len; pos++)
+	{
+		ring->data[(uint8_t) (head + pos) & ring->mask] = src[pos];
+	}
+
+	RING_commit (ring, len);
+
+	return 0;
+}
+
+uint8_t
+RING_pop_span (struct RING_buffer *ring, uint8_t *dst, uint8_t len)
+{
+	const uint8_t *span = NULL;
+	uint8_t popped = 0;
+
+	/* At most two contiguous spans: till the end and from the start */
+	while (popped < len)
+	{
+		uint8_t avail = RING_read_span (ring, &span);
+		uint8_t pos = 0;
+
+		if (avail == 0)
+		{
+			break;
+		}
+
+		if (avail > len - popped)
+		{
+			avail = len - popped;
+		}
+
+		for (; pos < avail; pos++)
+		{
+			dst[popped++] = span[pos];
+		}
+
+		RING_consume (ring, avail);
+	}
+
+	return popped;
+}
@@ -0,0 +1,195 @@
+#ifndef KS_RING
+#define KS_RING
+
+/**
+ * Single producer single consumer ring buffer of bytes used to hand over
+ * data between an interrupt and the main line without disabling the
+ * interrupts.
+ *
+ * The capacity is a power of two (at most 128) fixed at compile time
+ * (see RING_DEFINE). The head is written only by the producer and the
+ * tail only by the consumer. Both are free running 8-bit counters, so
+ * each is updated by a single (atomic) store and their difference is the
+ * number of bytes in the buffer even after they wrap.
+ *
+ * The data is always written (read) before the head (tail) is published,
+ * so neither side ever sees a partially written byte.
+ *
+ * Spans:
+ *
+ * 	RING_write_span/RING_commit and RING_read_span/RING_consume give
+ * 	direct access to the contiguous part of the free (used) space so
+ * 	that a batch of bytes could be produced (consumed) in place with a
+ * 	single index update. RING_push_span/RING_pop_span copy using them.
+ *
+ * Notes:
+ *
+ * 1. Exactly one context (the main line or one interrupt) may push and
+ *    exactly one may pop from a buffer.
+ *
+ * 2. Records of more than one byte should be pushed using a single
+ *    RING_push_span so that the consumer never sees a part of a record.
+ */
+
+#include <stdint.h>
+
+/* Prevents the compiler from moving memory accesses across it */
+#define RING_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+
+struct RING_buffer
+{
+	volatile uint8_t head;
+	volatile uint8_t tail;
+	uint8_t mask;
+	uint8_t *data;
+};
+
+/**
+ * RING_DEFINE:
+ *
+ * @name: name of the buffer
+ * @capacity: capacity in bytes; a power of two, at most 128
+ *
+ * Define a (static) ring buffer along with its storage.
+ */
+#define RING_DEFINE(name, capacity)                                      \
+	typedef char name##_capacity_check                               \
+		[(((capacity) & ((capacity) - 1)) == 0 &&                \
+		  (capacity) > 1 && (capacity) <= 128) ? 1 : -1];        \
+	static uint8_t name##_data[capacity];                            \
+	static struct RING_buffer name = { 0, 0, (capacity) - 1, name##_data }
+
+static inline uint8_t
+RING_count (const struct RING_buffer *ring)
+{
+	return (uint8_t) (ring->head - ring->tail);
+}
+
+static inline uint8_t
+RING_free (const struct RING_buffer *ring)
+{
+	return (uint8_t) (ring->mask + 1 - RING_count (ring));
+}
+
+/**
+ * RING_push:
+ *
+ * @ring: the buffer
+ * @byte: the byte to be added
+ *
+ * Returns: 0 if the byte was added. Non-zero value if the buffer is full.
+ */
+static inline int8_t
+RING_push (struct RING_buffer *ring, uint8_t byte)
+{
+	const uint8_t head = ring->head;
+
+	if ((uint8_t) (head - ring->tail) > ring->mask)
+	{
+		return 1;
+	}
+
+	ring->data[head & ring->mask] = byte;
+	RING_BARRIER ();
+	ring->head = head + 1;
+
+	return 0;
+}
+
+/**
+ * RING_pop:
+ *
+ * @ring: the buffer
+ * @byte: used to return the byte removed
+ *
+ * Returns: 0 if a byte was removed. Non-zero value if the buffer is empty.
+ */
+static inline int8_t
+RING_pop (struct RING_buffer *ring, uint8_t *byte)
+{
+	const uint8_t tail = ring->tail;
+
+	if (ring->head == tail)
+	{
+		return 1;
+	}
+
+	*byte = ring->data[tail & ring->mask];
+	RING_BARRIER ();
+	ring->tail = tail + 1;
+
+	return 0;
+}
+
+/**
+ * RING_write_span:
+ *
+ * @ring: the buffer
+ * @span: used to return the start of the free space
+ *
+ * Returns: number of contiguous free bytes starting at @span.
+ */
+uint8_t
+RING_write_span (struct RING_buffer *ring, uint8_t **span);
+
+/**
+ * RING_commit:
+ *
+ * @ring: the buffer
+ * @len: number of bytes written into the span (at most its length)
+ *
+ * Publish the bytes written into the span given by RING_write_span.
+ */
+void
+RING_commit (struct RING_buffer *ring, uint8_t len);
+
+/**
+ * RING_read_span:
+ *
+ * @ring: the buffer
+ * @span: used to return the start of the oldest bytes
+ *
+ * Returns: number of contiguous bytes available starting at @span.
+ */
+uint8_t
+RING_read_span (struct RING_buffer *ring, const uint8_t **span);
+
+/**
+ * RING_consume:
+ *
+ * @ring: the buffer
+ * @len: number of bytes read from the span (at most its length)
+ *
+ * Release the bytes read from the span given by RING_read_span.
+ */
+void
+RING_consume (struct RING_buffer *ring, uint8_t len);
+
+/**
+ * RING_push_span:
+ *
+ * @ring: the buffer
+ * @src: the bytes to be added
+ * @len: number of bytes
+ *
+ * Add all the bytes or none of them.
+ *
+ * Returns: 0 if the bytes were added. Non-zero value if there is not
+ *          enough free space.
+ */
+int8_t
+RING_push_span (struct RING_buffer *ring, const uint8_t *src, uint8_t len);
+
+/**
+ * RING_pop_span:
+ *
+ * @ring: the buffer
+ * @dst: used to return the bytes removed
+ * @len: maximum number of bytes
+ *
+ * Returns: number of bytes removed.
+ */
+uint8_t
+RING_pop_span (struct RING_buffer *ring, uint8_t *dst, uint8_t len);
+
+#endif
@@ -0,0 +1,328 @@
+#include <stddef.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include "sched.h"
+
+#ifdef SCHED_PROFILE
+#include "../prof/prof.h"
+#endif
+
+#ifdef SCHED_XTAL_TICK
+
+/*
+ * Timer0 configuration for a 1ms tick from the 32.768kHz square wave on T0
+ * (external clock, rising edge):
+ *
+ * 	32768 counts per 1000 ticks => 32 counts per tick and 768 counts
+ * 	spread over the 1000 ticks
+ *
+ * A tick of 33 counts is inserted whenever the spread counts add up to a
+ * count (as in drawing a line) so that the ticks never drift from the
+ * crystal. Every 125 ticks take exactly 4096 counts.
+ */
+#define TICK_PRESCALER_BITS ((1<<CS02) | (1<<CS01) | (1<<CS00))
+#define TICK_COUNTS 32u
+#define TICK_SPREAD_COUNTS 768u
+#define TICK_SPREAD_TICKS 1000u
+
+/* Fine ticks are the counts of Timer1: 1MHz / 8 (prescaler) */
+#define FINE_TICK_PRESCALER_BITS (1<<CS11)
+
+/* Ticks in the calibration window of 1/8s */
+#define CALIBRATION_TICKS 125u
+
+static uint16_t spread = 0;
+
+static uint16_t cycles_per_ms = 1000u;
+
+#else
+
+/*
+ * Timer0 configuration for a 1ms tick from the 1MHz clock:
+ *
+ * 	1MHz / 8 (prescaler) = 125kHz => 125 counts per ms
+ */
+#define TICK_PRESCALER_BITS (1<<CS01)
+#define TICK_COUNTS 125u
+
+#endif
+
+struct SCHED_task
+{
+	SCHED_task_fn fn;
+
+	/* Tick at which the task is due next */
+	uint16_t due;
+
+	/* 0 for a one-shot task */
+	uint16_t period;
+
+	uint8_t priority;
+};
+
+static struct SCHED_task tasks[SCHED_MAX_TASKS];
+
+static SCHED_task_fn idle_hook = NULL;
+
+static volatile uint16_t ticks = 0;
+
+ISR (TIMER0_COMP_vect)
+{
+	ticks++;
+
+#ifdef SCHED_XTAL_TICK
+	/*
+	 * The counter has just been cleared so the new value applies to the
+	 * tick that has begun.
+	 */
+	spread += TICK_SPREAD_COUNTS;
+	if (spread >= TICK_SPREAD_TICKS)
+	{
+		spread -= TICK_SPREAD_TICKS;
+		OCR0 = TICK_COUNTS;
+	}
+	else
+	{
+		OCR0 = TICK_COUNTS - 1;
+	}
+#endif
+}
+
+void
+SCHED_init (void)
+{
+	uint8_t id = 0;
+
+	for (; id < SCHED_MAX_TASKS; id++)
+	{
+		tasks[id].fn = NULL;
+	}
+
+#ifdef SCHED_XTAL_TICK
+	/* T0 is an input; the pull-up is needed as SQW/OUT is open drain */
+	DDRB &= ~(1<<PB0);
+	PORTB |= (1<<PB0);
+
+	/* Timer1 runs freely in the normal mode */
+	TCCR1A = 0;
+	TCCR1B = FINE_TICK_PRESCALER_BITS;
+	spread = 0;
+#endif
+
+	/* CTC mode, clear the counter on compare match */
+	TCCR0 = (1<<WGM01) | TICK_PRESCALER_BITS;
+	OCR0 = TICK_COUNTS - 1;
+	TCNT0 = 0;
+	TIMSK |= (1<<OCIE0);
+}
+
+uint16_t
+SCHED_ticks (void)
+{
+	uint16_t now = 0;
+
+	/* The 16-bit value could be updated by the ISR between the byte reads */
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		now = ticks;
+	}
+
+	return now;
+}
+
+#ifdef SCHED_XTAL_TICK
+
+uint16_t
+SCHED_fine_ticks (void)
+{
+	uint16_t now = 0;
+
+	/* The high byte is latched on reading the low byte */
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		now = TCNT1;
+	}
+
+	return now;
+}
+
+uint16_t
+SCHED_calibrate (void)
+{
+	uint16_t start_tick = 0, start = 0, end = 0;
+
+	/* Align to the start of a tick */
+	start_tick = SCHED_ticks ();
+	while (SCHED_ticks () == start_tick);
+
+	start = SCHED_fine_ticks ();
+	start_tick = SCHED_ticks ();
+	while ((uint16_t) (SCHED_ticks () - start_tick) < CALIBRATION_TICKS);
+	end = SCHED_fine_ticks ();
+
+	/*
+	 * The window is 1/8s of the crystal. Counts of 8 cycles each:
+	 *
+	 * 	cycles per ms = counts * 8 / 125
+	 */
+	cycles_per_ms = ((uint32_t) (uint16_t) (end - start) * 8u +
+	                 CALIBRATION_TICKS / 2) / CALIBRATION_TICKS;
+
+	return cycles_per_ms;
+}
+
+uint16_t
+SCHED_cycles_per_ms (void)
+{
+	return cycles_per_ms;
+}
+
+#else
+
+uint16_t
+SCHED_fine_ticks (void)
+{
+	uint16_t now = 0;
+	uint8_t count = 0;
+
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		now = ticks;
+		count = TCNT0;
+
+		/*
+		 * The counter has been cleared on a compare match that is
+		 * yet to be serviced; account for the pending tick.
+		 */
+		if (TIFR & (1<<OCF0))
+		{
+			now++;
+			count = TCNT0;
+		}
+	}
+
+	return now * TICK_COUNTS + count;
+}
+
+#endif
+
+int8_t
+SCHED_add (SCHED_task_fn task, uint16_t delay, uint16_t period, uint8_t priority)
+{
+	int8_t id = 0;
+
+	for (; id < SCHED_MAX_TASKS; id++)
+	{
+		if (tasks[id].fn == NULL)
+		{
+			tasks[id].due = SCHED_ticks () + delay;
+			tasks[id].period = period;
+			tasks[id].priority = priority;
+			tasks[id].fn = task;
+
+			return id;
+		}
+	}
+
+	return -1;
+}
+
+void
+SCHED_remove (int8_t id)
+{
+	if (id >= 0 && id < SCHED_MAX_TASKS)
+	{
+		tasks[id].fn = NULL;
+	}
+}
+
+void
+SCHED_set_idle_hook (SCHED_task_fn hook)
+{
+	idle_hook = hook;
+}
+
+/**
+ * SCHED_next_due:
+ *
+ * @now: the current tick
+ *
+ * Returns: the due task with the highest priority or NULL if no
+ *          task is due.
+ */
+static struct SCHED_task *
+SCHED_next_due (uint16_t now)
+{
+	struct SCHED_task *next = NULL;
+	uint8_t id = 0;
+
+	for (; id < SCHED_MAX_TASKS; id++)
+	{
+		struct SCHED_task *const task = &tasks[id];
+
+		/* Difference is taken so that the wrap of the ticks is handled */
+		if (task->fn == NULL || (int16_t) (now - task->due) < 0)
+		{
+			continue;
+		}
+
+		if (next == NULL || task->priority < next->priority)
+		{
+			next = task;
+		}
+	}
+
+	return next;
+}
+
+void
+SCHED_run (void)
+{
+	sei ();
+
+	while (1)
+	{
+		const uint16_t now = SCHED_ticks ();
+		struct SCHED_task *const task = SCHED_next_due (now);
+		SCHED_task_fn fn = NULL;
+
+		if (task == NULL)
+		{
+			if (idle_hook != NULL)
+			{
+				idle_hook ();
+			}
+
+			continue;
+		}
+
+		fn = task->fn;
+
+		if (task->period == 0)
+		{
+			/* One-shot; free the slot before running so it could be reused */
+			task->fn = NULL;
+		}
+		else
+		{
+			task->due += task->period;
+
+			/* Skip the missed runs instead of running them back to back */
+			if ((int16_t) (now - task->due) >= 0)
+			{
+				task->due = now + task->period;
+			}
+		}
+
+#ifdef SCHED_PROFILE
+		{
+			const uint16_t start = PROF_begin ();
+
+			fn ();
+			PROF_end (PROF_ENTRY_TASK (task - tasks), start);
+		}
+#else
+		fn ();
+#endif
+	}
+}
@@ -0,0 +1,181 @@
+#ifndef KS_SCHED_ATMEGA32
+#define KS_SCHED_ATMEGA32
+
+/**
+ * A small cooperative task scheduler for the ATMEGA32 running at 1MHz.
+ *
+ * Timer0 is used in CTC mode to generate a tick every 1ms. The interrupt
+ * only counts the ticks; the tasks are run to completion from the main
+ * line by SCHED_run in the order of their priority.
+ *
+ * Tasks:
+ *
+ * 	- A task is a function that does a small amount of work and returns.
+ * 	  It must not busy wait as no other task runs till it returns.
+ *
+ * 	- A periodic task is run every 'period' ms. The next run is
+ * 	  scheduled from the time it was due and not from when it was run
+ * 	  so that periodic tasks do not drift.
+ *
+ * 	- A one-shot task (period 0) is removed after it has run once.
+ *
+ * 	- When more than one task is due, the one with the lowest priority
+ * 	  value is run first. Tasks of the same priority are run in the
+ * 	  order of their slots in the task table (the lowest id first): a
+ * 	  task added after another was removed takes the freed slot and
+ * 	  could hence run before the tasks added earlier. Only one task
+ * 	  is run before the due tasks are looked up again so the latency
+ * 	  of a task is bounded by the longest run of a single task.
+ *
+ * 	- When no task is due the idle hook (if any) is invoked.
+ *
+ * Notes:
+ *
+ * 1. Timer0 must not be used by anything else.
+ *
+ * 2. Global interrupts are enabled by SCHED_run.
+ *
+ * Crystal tick (build with SCHED_XTAL_TICK defined):
+ *
+ * 	The 1MHz RC oscillator drifts by a few percent with the temperature
+ * 	and so do the ticks derived from it. When built with SCHED_XTAL_TICK
+ * 	defined, Timer0 instead counts the 32.768kHz square wave of the
+ * 	DS1307 on T0 (PB0) and the ticks are as accurate as its crystal.
+ * 	The SQW/OUT has to be configured by the application (see
+ * 	RTC_set_control in i2c_rtc/rtc/rtc.h).
+ *
+ * 	The fine ticks then come from Timer1 which runs freely from the
+ * 	CPU clock and hence must not be used by anything else either.
+ * 	SCHED_calibrate measures the CPU clock against the crystal so that
+ * 	the busy waits could be corrected. Only the waits of the I2C driver
+ * 	are corrected so far (see i2c_rtc/rtc.c): the fine ticks still
+ * 	count the RC clock, so the waits timed in them (e.g. those of
+ * 	lcd_async.h) drift with it as before.
+ *
+ * Profiling (build with SCHED_PROFILE defined):
+ *
+ * 	The execution time of every task run is accounted to its entry in
+ * 	the profiler (see scheduler/prof/prof.h). The profiler takes
+ * 	Timer1, so such a build conflicts with the other users of Timer1
+ * 	(e.g. the BAM of led_blink/led/led.c), and its load meter needs the
+ * 	idle hook, so it conflicts with POWER_idle as well.
+ */
+
+#include <stdint.h>
+#include <avr/io.h>
+
+#define SCHED_MAX_TASKS 8
+
+/* Priority values; lower values are run first */
+#define SCHED_PRIORITY_HIGH 0u
+#define SCHED_PRIORITY_NORMAL 1u
+#define SCHED_PRIORITY_LOW 2u
+
+/*
+ * Fine ticks are the counts of Timer0 (Timer1 with SCHED_XTAL_TICK)
+ * (8us each) and are used to time the waits shorter than a tick.
+ */
+#define SCHED_FINE_TICKS_PER_MS 125u
+#define SCHED_US_TO_FINE_TICKS(us) (((us) + 7u) / 8u)
+#define SCHED_MS_TO_FINE_TICKS(ms) ((ms) * SCHED_FINE_TICKS_PER_MS)
+
+typedef void (*SCHED_task_fn) (void);
+
+/**
+ * SCHED_init:
+ *
+ * Configure Timer0 to generate the 1ms tick and clear the task table.
+ */
+void
+SCHED_init (void);
+
+/**
+ * SCHED_add:
+ *
+ * @task: the function to be run
+ * @delay: time in ms after which the task is to be run for the first time
+ * @period: time in ms between successive runs; 0 for a one-shot task
+ * @priority: priority of the task (see SCHED_PRIORITY_*)
+ *
+ * Add a task to the scheduler. Could also be invoked from within a task.
+ *
+ * Note: @delay and @period must be less than 32768ms.
+ *
+ * Returns: the id of the task which could be used to remove it or -1
+ *          if there is no free slot.
+ */
+int8_t
+SCHED_add (SCHED_task_fn task, uint16_t delay, uint16_t period, uint8_t priority);
+
+/**
+ * SCHED_remove:
+ *
+ * @id: the id of the task returned by SCHED_add
+ *
+ * Remove the task from the scheduler. Removing a one-shot task that
+ * has already run does nothing.
+ */
+void
+SCHED_remove (int8_t id);
+
+/**
+ * SCHED_set_idle_hook:
+ *
+ * @hook: function to be invoked when no task is due (could be NULL)
+ */
+void
+SCHED_set_idle_hook (SCHED_task_fn hook);
+
+/**
+ * SCHED_ticks:
+ *
+ * Returns: the number of 1ms ticks since SCHED_init (wraps around).
+ */
+uint16_t
+SCHED_ticks (void);
+
+/**
+ * SCHED_fine_ticks:
+ *
+ * Returns: the time since SCHED_init in units of 8us (wraps around
+ *          every ~524ms). Intended to measure short intervals by taking
+ *          the difference of two values.
+ */
+uint16_t
+SCHED_fine_ticks (void);
+
+#ifdef SCHED_XTAL_TICK
+
+/**
+ * SCHED_calibrate:
+ *
+ * Count the CPU cycles over 125 ticks (1/8s) of the crystal. Busy waits
+ * for that long so it is meant to be invoked at startup (or occasionally
+ * from a low priority task). Global interrupts must be enabled.
+ *
+ * Returns: the number of CPU cycles per ms (1000 for an exact 1MHz).
+ */
+uint16_t
+SCHED_calibrate (void);
+
+/**
+ * SCHED_cycles_per_ms:
+ *
+ * Returns: the number of CPU cycles per ms as measured by the last
+ *          SCHED_calibrate (1000 if it has not been invoked).
+ */
+uint16_t
+SCHED_cycles_per_ms (void);
+
+#endif
+
+/**
+ * SCHED_run:
+ *
+ * Enable interrupts and keep running the tasks as they become due.
+ * Never returns.
+ */
+void
+SCHED_run (void) __attribute__ ((noreturn));
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef KS_SEQLOCK
+#define KS_SEQLOCK
+
+/**
+ * Sequence counter used to read data updated by an interrupt without
+ * disabling the interrupt.
+ *
+ * The writer (the interrupt) increments the counter before and after
+ * updating the data, so the counter is odd while an update is in
+ * progress. A reader notes the counter, copies the data and retries if
+ * the counter has changed meanwhile:
+ *
+ * 	do
+ * 	{
+ * 		start = SEQLOCK_read_begin (&seq);
+ * 		copy = data;
+ * 	} while (SEQLOCK_read_retry (&seq, start));
+ *
+ * The writer never waits, so the latency of the interrupt is not
+ * affected by the readers.
+ *
+ * Notes:
+ *
+ * 1. There must be a single writer (or the writers must exclude each
+ *    other).
+ *
+ * 2. The data is accessed by plain loads and stores; the barriers keep
+ *    the compiler from moving them across the counter updates.
+ *
+ * 3. A reader must never run in a context that has interrupted the
+ *    writer (e.g. a nested interrupt enabled from within the writing
+ *    ISR): the update could not complete till the reader returns, so
+ *    the reader would retry forever.
+ */
+
+#include <stdint.h>
+
+#define SEQLOCK_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+
+static inline void
+SEQLOCK_write_begin (volatile uint8_t *seq)
+{
+	*seq = *seq + 1;
+	SEQLOCK_BARRIER ();
+}
+
+static inline void
+SEQLOCK_write_end (volatile uint8_t *seq)
+{
+	SEQLOCK_BARRIER ();
+	*seq = *seq + 1;
+}
+
+static inline uint8_t
+SEQLOCK_read_begin (const volatile uint8_t *seq)
+{
+	const uint8_t start = *seq;
+
+	SEQLOCK_BARRIER ();
+
+	return start;
+}
+
+static inline _Bool
+SEQLOCK_read_retry (const volatile uint8_t *seq, uint8_t start)
+{
+	SEQLOCK_BARRIER ();
+
+	/* An odd start means the copy was made during an update */
+	return (start & 1) || *seq != start;
+}
+
+#endif
@@ -0,0 +1,134 @@
+/**
+ * Program to test the cooperative scheduler by running several
+ * activities on the same controller at the same time.
+ *
+ * PORTA - input from switches (4-7, active high)
+ * PORTB - output:
+ *
+ * 	Pin 0: heartbeat (toggles every 500ms)
+ * 	Pin 1: turned on once, 3s after reset
+ * 	Pin 4-7: debounced state of the switches
+ *
+ * The MCU sleeps (Idle mode) whenever no task is due. A change of the
+ * switches wakes it up through the debounce interrupt (which invokes
+ * POWER_notify) and is shown before it sleeps again.
+ *
+ * PORTC - output: longest wake-up latency (in 8us fine ticks, saturated
+ *                 at 255) of a change of the switches
+ * PORTD - output: percentage of the time asleep
+ *
+ * Both are updated every second.
+ *
+ * Profiling variant (built with SCHED_PROFILE defined, see the Makefile):
+ *
+ * 	The MCU does not sleep as the load is measured from the idle loop.
+ * 	The tasks start after the calibration of the profiler.
+ *
+ * 	PORTC - output: CPU load in percent
+ * 	PORTD - output: longest run (in cycles, saturated at 255) of each
+ * 	                task in turn, switching every second
+ */
+
+#include <avr/io.h>
+#include "../sched/sched.h"
+#include "../power/power.h"
+#include "../../input_output/input/input.h"
+#ifdef SCHED_PROFILE
+#include "../prof/prof.h"
+#endif
+
+#ifdef SCHED_PROFILE
+/* Delay of the tasks so that the calibration slot of the profiler is idle */
+#define TASK_DELAY (2 * PROF_SLOT_MS)
+#else
+#define TASK_DELAY 0
+#endif
+
+static void
+heartbeat (void)
+{
+	PORTB ^= (1<<PB0);
+}
+
+/**
+ * idle:
+ *
+ * Idle hook: show the switches that changed since the last time, then
+ * sleep (or count the idle loop when profiling).
+ */
+static void
+idle (void)
+{
+	if (INPUT_get_pressed (0xF0) | INPUT_get_released (0xF0))
+	{
+		PORTB = (PORTB & 0x0F) | INPUT_state ();
+	}
+
+#ifdef SCHED_PROFILE
+	PROF_idle ();
+#else
+	POWER_idle ();
+#endif
+}
+
+static void
+startup_done (void)
+{
+	PORTB |= (1<<PB1);
+}
+
+#ifdef SCHED_PROFILE
+static void
+report (void)
+{
+	static uint8_t entry = 0;
+	struct PROF_entry times;
+
+	PORTC = PROF_load ();
+
+	PROF_get_entry (PROF_ENTRY_TASK (entry), &times);
+	PORTD = (times.max > 0xFF) ? 0xFF : times.max;
+
+	entry = (entry + 1) % SCHED_MAX_TASKS;
+}
+#else
+static void
+report (void)
+{
+	struct POWER_stats stats;
+
+	POWER_get_stats (&stats);
+
+	PORTC = (stats.latency_max > 0xFF) ? 0xFF : stats.latency_max;
+	PORTD = stats.asleep_percent;
+}
+#endif
+
+int main (void)
+{
+	DDRA = 0x00;
+	DDRB = 0xFF;
+	PORTB = 0x00;
+
+	DDRC = 0xFF;
+	DDRD = 0xFF;
+
+	SCHED_init ();
+	INPUT_init (0x00);
+
+#ifdef SCHED_PROFILE
+	/* The load is measured by counting the iterations of the idle loop */
+	PROF_init ();
+#else
+	/* Sleep between the ticks instead of spinning */
+	POWER_init (POWER_MODE_IDLE);
+#endif
+
+	SCHED_set_idle_hook (idle);
+
+	SCHED_add (report, TASK_DELAY, 1000, SCHED_PRIORITY_LOW);
+	SCHED_add (heartbeat, TASK_DELAY, 500, SCHED_PRIORITY_NORMAL);
+	SCHED_add (startup_done, 3000, 0, SCHED_PRIORITY_LOW);
+
+	SCHED_run ();
+}